@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "BalanceRunner.hpp"
+#include "JobSystem.hpp"
+#include "Level.hpp"
+#include "ToolSupport.hpp"
+#include "TowerLayout.hpp"
+
+// Plays a level with every given layout and many seeds, each game headlessly
+// and on its own, spread over all cores, and reports how the layouts fare.
+// Usage: TDBalance <level.json> [layout.json...] [--seeds N] [--first-seed S]
+//                  [--max-ticks N] [--sample N] [--threads N] [--csv file]
+// Without layouts the level is played without towers. Seeds S .. S + N - 1
+// are used with every layout. Money is sampled every --sample ticks into
+// curves; --csv writes every game on a line of its own, curve included.
+
+static const int64_t DEFAULT_SAMPLE_INTERVAL = 60 * 10;
+
+static void printUsage(const char * argv0)
+{
+	std::cout << "Usage: " << argv0 << " <level.json> [layout.json...] [--seeds N] [--first-seed S]"
+		<< " [--max-ticks N] [--sample N] [--threads N] [--csv file]" << std::endl;
+}
+
+int main(int argc, char ** argv)
+{
+	std::string levelPath, csvPath;
+	std::vector<std::string> layoutPaths;
+	uint64_t seedCount = 100;
+	uint64_t firstSeed = 0;
+	int64_t maxTicks = DEFAULT_MAX_TICKS;
+	int64_t sampleInterval = DEFAULT_SAMPLE_INTERVAL;
+	uint32_t workerCount = JobSystem::getDefaultWorkerCount();
+
+	for (int i = 1; i < argc; ++i) {
+		if (!strcmp(argv[i], "--seeds") && i + 1 < argc)
+			seedCount = std::strtoull(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--first-seed") && i + 1 < argc)
+			firstSeed = std::strtoull(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--max-ticks") && i + 1 < argc)
+			maxTicks = std::strtoll(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--sample") && i + 1 < argc)
+			sampleInterval = std::strtoll(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+			workerCount = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--csv") && i + 1 < argc)
+			csvPath = argv[++i];
+		else if (argv[i][0] == '-') {
+			printUsage(argv[0]);
+			return 1;
+		}
+		else if (levelPath.empty())
+			levelPath = argv[i];
+		else
+			layoutPaths.push_back(argv[i]);
+	}
+
+	if (levelPath.empty() || seedCount == 0) {
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	try {
+		std::ifstream levelSource(levelPath);
+		if (!levelSource.is_open())
+			throw std::runtime_error("Cannot open " + levelPath);
+		auto level = std::make_shared<Level>(levelSource);
+
+		std::vector<TowerLayout> layouts;
+		for (const auto & layoutPath : layoutPaths) {
+			std::ifstream layoutSource(layoutPath);
+			if (!layoutSource.is_open())
+				throw std::runtime_error("Cannot open " + layoutPath);
+			layouts.emplace_back(layoutSource);
+		}
+		if (layouts.empty()) {
+			layouts.emplace_back();
+			layoutPaths.push_back("(no towers)");
+		}
+
+		std::vector<uint64_t> seeds;
+		for (uint64_t i = 0; i < seedCount; ++i)
+			seeds.push_back(firstSeed + i);
+
+		JobSystem jobs(workerCount);
+		BalanceRunner runner(level, maxTicks, sampleInterval);
+
+		const auto start = std::chrono::steady_clock::now();
+		const auto games = runner.playAll(jobs, layouts, seeds);
+		const double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		const int64_t startingLives = level->getStartingLives();
+		if (!csvPath.empty()) {
+			std::ofstream csv(csvPath);
+			if (!csv.is_open())
+				throw std::runtime_error("Cannot open " + csvPath);
+			csv << "layout,seed,outcome,lives,lives_lost,money,ticks,failed_placements,ms,money_curve" << std::endl;
+			for (const auto & game : games) {
+				csv << layoutPaths[game.layout] << "," << game.seed << ","
+					<< (game.won ? "won" : game.lives <= 0 ? "lost" : "undecided") << ","
+					<< game.lives << "," << startingLives - game.lives << "," << game.money << ","
+					<< game.ticks << "," << game.failedPlacements << "," << game.seconds * 1000.0 << ",";
+				for (size_t i = 0; i < game.moneyCurve.size(); ++i)
+					csv << (i ? " " : "") << game.moneyCurve[i];
+				csv << std::endl;
+			}
+		}
+
+		std::cout << std::fixed << std::setprecision(2);
+		std::cout << "Level:        " << levelPath << std::endl;
+		std::cout << "Games:        " << games.size() << " (" << layouts.size() << " layouts x "
+			<< seeds.size() << " seeds from " << firstSeed << ")" << std::endl;
+
+		for (size_t layout = 0; layout < layouts.size(); ++layout) {
+			const auto first = games.begin() + layout * seeds.size();
+			const auto last = first + seeds.size();
+
+			size_t wins = 0;
+			int64_t livesLost = 0;
+			int64_t minLivesLost = std::numeric_limits<int64_t>::max();
+			int64_t maxLivesLost = std::numeric_limits<int64_t>::min();
+			int32_t failedPlacements = 0;
+			std::vector<double> gameTimes;
+			size_t curveLength = 0;
+			for (auto game = first; game != last; ++game) {
+				wins += game->won;
+				livesLost += startingLives - game->lives;
+				minLivesLost = std::min(minLivesLost, startingLives - game->lives);
+				maxLivesLost = std::max(maxLivesLost, startingLives - game->lives);
+				failedPlacements += game->failedPlacements;
+				gameTimes.push_back(game->seconds * 1000.0);
+				curveLength = std::max(curveLength, game->moneyCurve.size());
+			}
+			std::sort(gameTimes.begin(), gameTimes.end());
+
+			// Games which ended early keep their final money for the rest of the curve
+			std::vector<double> moneyCurve(curveLength, 0.0);
+			for (auto game = first; game != last; ++game) {
+				for (size_t i = 0; i < curveLength; ++i)
+					moneyCurve[i] += i < game->moneyCurve.size() ? game->moneyCurve[i] : game->money;
+			}
+
+			const double count = (double)seeds.size();
+			std::cout << "Layout:       " << layoutPaths[layout] << " (" << failedPlacements / count
+				<< " placements failed per game)" << std::endl;
+			std::cout << "  Win rate:   " << 100.0 * wins / count << "%" << std::endl;
+			std::cout << "  Lives lost: mean " << livesLost / count << ", min " << minLivesLost
+				<< ", max " << maxLivesLost << " of " << startingLives << std::endl;
+			std::cout << "  Money:      mean every " << sampleInterval << " ticks:";
+			for (double money : moneyCurve)
+				std::cout << " " << (int64_t)(money / count);
+			std::cout << std::endl;
+			std::cout << "  Game time:  mean " << std::accumulate(gameTimes.begin(), gameTimes.end(), 0.0) / count
+				<< " ms, p50 " << percentile(gameTimes, 0.5) << " ms, p99 " << percentile(gameTimes, 0.99)
+				<< " ms, max " << gameTimes.back() << " ms" << std::endl;
+		}
+
+		std::cout << "Threads:      " << jobs.getWorkerCount() + 1 << std::endl;
+		std::cout << "Wall time:    " << wallSeconds << " s";
+		if (wallSeconds > 0.0)
+			std::cout << " (" << games.size() / wallSeconds << " games/s)";
+		std::cout << std::endl;
+
+		return 0;
+	}
+
+	catch (std::exception & err) {
+		std::cout << "Runtime error: " << err.what() << std::endl;
+		return 1;
+	}
+}
@@ -0,0 +1,60 @@
+#include <chrono>
+#include "BalanceRunner.hpp"
+#include "Constants.hpp"
+#include "JobSystem.hpp"
+#include "Level.hpp"
+
+BalanceRunner::BalanceRunner(std::shared_ptr<Level> level, int64_t maxTicks, int64_t sampleInterval)
+	: level_(level)
+	, maxTicks_(maxTicks)
+	, sampleInterval_(sampleInterval)
+{
+}
+
+BalanceRunner::game_t BalanceRunner::play(const TowerLayout & layout, uint64_t seed) const
+{
+	typedef std::chrono::steady_clock clock_t;
+	const auto start = clock_t::now();
+
+	game_t game;
+	game.layout = 0;
+	game.seed = seed;
+	game.failedPlacements = 0;
+
+	// Games run in parallel with each other, so each one runs serially
+	auto levelInstance = std::make_shared<LevelInstance>(level_, seed);
+	levelInstance->resume();
+
+	const sf::Time dt = sf::seconds(Constants::SECONDS_PER_FRAME);
+	int64_t tick = 0;
+	while (tick < maxTicks_ && !levelInstance->hasWon() && !levelInstance->hasLost()) {
+		if (sampleInterval_ > 0 && tick % sampleInterval_ == 0)
+			game.moneyCurve.push_back(levelInstance->getMoney());
+		game.failedPlacements += layout.apply(*levelInstance, tick);
+		levelInstance->update(dt);
+		++tick;
+	}
+
+	game.won = levelInstance->hasWon();
+	game.lives = levelInstance->getLives();
+	game.money = levelInstance->getMoney();
+	game.ticks = tick;
+	game.seconds = std::chrono::duration<double>(clock_t::now() - start).count();
+	return game;
+}
+
+std::vector<BalanceRunner::game_t> BalanceRunner::playAll(
+	JobSystem & jobs,
+	const std::vector<TowerLayout> & layouts,
+	const std::vector<uint64_t> & seeds) const
+{
+	std::vector<game_t> games(layouts.size() * seeds.size());
+	jobs.parallelFor(games.size(), 1, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			const size_t layout = i / seeds.size();
+			games[i] = play(layouts[layout], seeds[i % seeds.size()]);
+			games[i].layout = layout;
+		}
+	});
+	return games;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#ifndef TDF_BALANCE_RUNNER_HPP
+#define TDF_BALANCE_RUNNER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "TowerLayout.hpp"
+
+class JobSystem;
+class Level;
+
+//! \brief Plays a Level headlessly with scripted TowerLayouts and many seeds,
+//! to see how hard the Level is without playing it by hand.
+//! Games are independent, so they are played on all threads of a JobSystem.
+class BalanceRunner
+{
+public:
+	//! How a single game went.
+	struct game_t
+	{
+		size_t layout;
+		uint64_t seed;
+		bool won;
+		int64_t lives;
+		int64_t money;
+		int64_t ticks;
+		int32_t failedPlacements;
+		double seconds;
+		//! Money at the beginning of every sampleInterval-th tick, until the game ended.
+		std::vector<int64_t> moneyCurve;
+	};
+
+private:
+	std::shared_ptr<Level> level_;
+	int64_t maxTicks_;
+	int64_t sampleInterval_;
+
+public:
+	BalanceRunner(std::shared_ptr<Level> level, int64_t maxTicks, int64_t sampleInterval);
+
+	//! Plays a single game until it is won, lost or maxTicks long.
+	game_t play(const TowerLayout & layout, uint64_t seed) const;
+
+	//! \brief Plays every layout with every seed, in parallel.
+	//! Games are returned by layout, then by seed, whatever the thread count.
+	std::vector<game_t> playAll(
+		JobSystem & jobs,
+		const std::vector<TowerLayout> & layouts,
+		const std::vector<uint64_t> & seeds) const;
+};
+
+#endif // TDF_BALANCE_RUNNER_HPP
@@ -0,0 +1,252 @@
+#pragma once
+
+#ifndef TDF_BINARY_STREAM_HPP
+#define TDF_BINARY_STREAM_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <SFML/System.hpp>
+
+//! \brief Appends values to a memory buffer in a compact, portable form.
+//! Integers are LEB128 varints, signed ones zig-zag encoded first;
+//! floating point numbers keep their exact bits, in little endian order.
+class BinaryWriter
+{
+private:
+	//! Only the first size_ bytes of the buffer were written, the rest is room to grow.
+	std::string buffer_;
+	size_t size_;
+
+	//! Returns where the given number of bytes can be written.
+	inline char * grow(size_t bytes)
+	{
+		if (buffer_.size() - size_ < bytes)
+			buffer_.resize(std::max(2 * buffer_.size(), size_ + bytes));
+		char * at = &buffer_[size_];
+		size_ += bytes;
+		return at;
+	}
+
+public:
+	BinaryWriter() : size_(0) {}
+
+	const std::string & getBuffer()
+	{
+		buffer_.resize(size_);
+		return buffer_;
+	}
+
+	//! Moves the written data out, leaving the writer empty.
+	std::string takeBuffer()
+	{
+		std::string buffer;
+		buffer_.resize(size_);
+		buffer.swap(buffer_);
+		size_ = 0;
+		return buffer;
+	}
+
+	inline void writeByte(uint8_t value)
+	{
+		*grow(1) = (char)value;
+	}
+
+	inline void writeBytes(const char * data, size_t size)
+	{
+		if (size)
+			memcpy(grow(size), data, size);
+	}
+
+	inline void writeUnsigned(uint64_t value)
+	{
+		// Reserve the longest encoding, then give back what was not used
+		char * at = grow(10);
+		char * const start = at;
+		while (value >= 0x80) {
+			*at++ = (char)(value | 0x80);
+			value >>= 7;
+		}
+		*at++ = (char)value;
+		size_ -= 10 - (at - start);
+	}
+
+	inline void writeSigned(int64_t value)
+	{
+		writeUnsigned(((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+	}
+
+	//! Writes the lowest bytes of the value, without compression.
+	inline void writeFixed(uint64_t value, int bytes)
+	{
+		char data[8];
+		for (int i = 0; i < bytes; ++i)
+			data[i] = (char)(value >> (8 * i));
+		writeBytes(data, bytes);
+	}
+
+	inline void writeFloat(float value)
+	{
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		writeFixed(bits, sizeof(bits));
+	}
+
+	inline void writeDouble(double value)
+	{
+		uint64_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		writeFixed(bits, sizeof(bits));
+	}
+
+	inline void writeString(const std::string & value)
+	{
+		writeUnsigned(value.size());
+		writeBytes(value.data(), value.size());
+	}
+
+	inline void writeVector(sf::Vector2i value)
+	{
+		writeSigned(value.x);
+		writeSigned(value.y);
+	}
+
+	inline void writeVector(sf::Vector2f value)
+	{
+		writeFloat(value.x);
+		writeFloat(value.y);
+	}
+
+	inline void writeTime(sf::Time value)
+	{
+		writeSigned(value.asMicroseconds());
+	}
+};
+
+//! \brief Reads values written by BinaryWriter from a memory buffer.
+//! Reading past the end throws std::runtime_error.
+class BinaryReader
+{
+private:
+	const char * data_;
+	size_t size_;
+	size_t position_;
+
+	inline void require(size_t bytes) const
+	{
+		if (size_ - position_ < bytes)
+			throw std::runtime_error("Unexpected end of binary data");
+	}
+
+public:
+	BinaryReader(const char * data, size_t size)
+		: data_(data)
+		, size_(size)
+		, position_(0)
+	{}
+
+	explicit BinaryReader(const std::string & buffer)
+		: BinaryReader(buffer.data(), buffer.size())
+	{}
+
+	inline bool atEnd() const
+	{
+		return position_ == size_;
+	}
+
+	inline uint8_t readByte()
+	{
+		require(1);
+		return (uint8_t)data_[position_++];
+	}
+
+	inline void readBytes(char * target, size_t size)
+	{
+		require(size);
+		memcpy(target, data_ + position_, size);
+		position_ += size;
+	}
+
+	inline uint64_t readUnsigned()
+	{
+		uint64_t value = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			const uint8_t byte = readByte();
+			value |= (uint64_t)(byte & 0x7f) << shift;
+			if (!(byte & 0x80))
+				return value;
+		}
+		throw std::runtime_error("Malformed number in binary data");
+	}
+
+	inline int64_t readSigned()
+	{
+		const uint64_t value = readUnsigned();
+		return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+	}
+
+	inline uint64_t readFixed(int bytes)
+	{
+		uint64_t value = 0;
+		for (int i = 0; i < bytes; ++i)
+			value |= (uint64_t)readByte() << (8 * i);
+		return value;
+	}
+
+	inline float readFloat()
+	{
+		const uint32_t bits = (uint32_t)readFixed(sizeof(bits));
+		float value;
+		memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	inline double readDouble()
+	{
+		const uint64_t bits = readFixed(sizeof(bits));
+		double value;
+		memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	inline std::string readString()
+	{
+		const uint64_t size = readUnsigned();
+		require((size_t)size);
+		std::string value(data_ + position_, (size_t)size);
+		position_ += (size_t)size;
+		return value;
+	}
+
+	//! Reads a count of elements, each taking at least one byte.
+	inline size_t readCount()
+	{
+		const uint64_t count = readUnsigned();
+		require((size_t)count);
+		return (size_t)count;
+	}
+
+	inline sf::Vector2i readVector2i()
+	{
+		const int x = (int)readSigned();
+		const int y = (int)readSigned();
+		return { x, y };
+	}
+
+	inline sf::Vector2f readVector2f()
+	{
+		const float x = readFloat();
+		const float y = readFloat();
+		return { x, y };
+	}
+
+	inline sf::Time readTime()
+	{
+		return sf::microseconds(readSigned());
+	}
+};
+
+#endif // TDF_BINARY_STREAM_HPP
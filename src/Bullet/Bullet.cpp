@@ -1,8 +1,6 @@
 #include "Bullet.hpp"
 
-Bullet::Bullet(
-	std::unique_ptr<BulletMovementComponent> movementComponent,
-	std::unique_ptr<BulletDisplayComponent> displayComponent)
-	: movementComponent_(std::move(movementComponent))
-	, displayComponent_(std::move(displayComponent))
+Bullet::Bullet(BulletMovementComponent movementComponent, uint8_t typeId)
+	: movementComponent_(movementComponent)
+	, typeId_(typeId)
 {}
@@ -3,44 +3,65 @@
 #ifndef TDF_BULLET_HPP
 #define TDF_BULLET_HPP
 
-#include <memory>
-
-#include <SFML/Graphics.hpp>
-#include "../Creep/Creep.hpp"
-#include "../Renderable.hpp"
-#include "BulletDisplayComponent.hpp"
+#include <cstdint>
+#include <SFML/System.hpp>
 #include "BulletMovementComponent.hpp"
 
-//! Represents a Bullet shot from a Tower.
-class Bullet : public Renderable
+//! \brief Represents a Bullet shot from a Tower.
+//! A plain record without heap allocated parts, so that Bullets can be kept
+//! by value in an EntityRegistry which recycles their storage.
+class Bullet
 {
 private:
-	std::unique_ptr<BulletMovementComponent> movementComponent_;
-	std::unique_ptr<BulletDisplayComponent> displayComponent_;
+	BulletMovementComponent movementComponent_;
+	uint8_t typeId_;
 
 public:
-	Bullet(
-		std::unique_ptr<BulletMovementComponent> movementComponent,
-		std::unique_ptr<BulletDisplayComponent> displayComponent);
+	//! The type id is given by BulletFactory, which knows the name behind it.
+	Bullet(BulletMovementComponent movementComponent, uint8_t typeId);
+
+	inline uint8_t getTypeId() const
+	{
+		return typeId_;
+	}
 
-	inline void update(sf::Time dt)
+	inline bool fly(sf::Time dt)
 	{
-		movementComponent_->update(dt);
+		return movementComponent_.fly(dt);
 	}
 
-	inline virtual void render(sf::RenderTarget & target) override
+	inline void hit()
 	{
-		displayComponent_->render(target);
+		movementComponent_.hit();
 	}
 
 	inline sf::Vector2f getPosition() const
 	{
-		return movementComponent_->getPosition();
+		return movementComponent_.getPosition();
+	}
+
+	inline sf::Vector2f getTargetPosition() const
+	{
+		return movementComponent_.getTargetPosition();
 	}
 
 	inline bool isAlive() const
 	{
-		return movementComponent_->isAlive();
+		return movementComponent_.isAlive();
+	}
+
+	inline void save(BinaryWriter & writer) const
+	{
+		writer.writeByte(typeId_);
+		movementComponent_.save(writer);
+	}
+
+	//! \brief Reads a saved Bullet. Its target is checked against the Creeps
+	//! loaded with it, which are to replace those of the store it flies in.
+	static inline Bullet load(BinaryReader & reader, const CreepStore & loaded, CreepStore & creeps)
+	{
+		const uint8_t typeId = reader.readByte();
+		return Bullet(BulletMovementComponent::load(reader, loaded, creeps), typeId);
 	}
 };
 
@@ -1,22 +1,53 @@
 #include "BulletDamageComponent.hpp"
-#include "../Creep/Creep.hpp"
+#include "../Creep/CreepStore.hpp"
 
-BulletSimpleDamageComponent::BulletSimpleDamageComponent(int32_t damage)
-	: damage_(damage)
+BulletDamageComponent::BulletDamageComponent(Type type, int32_t damage, CreepBuff buff)
+	: type_(type)
+	, damage_(damage)
+	, buff_(buff)
 {
 }
 
-void BulletSimpleDamageComponent::damage(std::shared_ptr<Creep> creep) const
+BulletDamageComponent BulletDamageComponent::simple(int32_t damage)
 {
-	creep->inflictDamage(damage_);
+	return BulletDamageComponent(Type::SIMPLE, damage, CreepBuff(0., CreepBuff::Type::BUFF_SPEED, 0.f));
 }
 
-BulletBuffDamageComponent::BulletBuffDamageComponent(CreepBuff buff)
-	: buff_(buff)
+BulletDamageComponent BulletDamageComponent::buff(CreepBuff buff)
 {
+	return BulletDamageComponent(Type::BUFF, 0, buff);
 }
 
-void BulletBuffDamageComponent::damage(std::shared_ptr<Creep> creep) const
+void BulletDamageComponent::damage(CreepStore & creeps, uint32_t index) const
 {
-	creep->applyBuff(buff_);
+	switch (type_) {
+	case Type::SIMPLE:
+		creeps.inflictDamage(index, damage_);
+		break;
+	case Type::BUFF:
+		creeps.applyBuff(index, buff_);
+		break;
+	}
+}
+
+void BulletDamageComponent::save(BinaryWriter & writer) const
+{
+	writer.writeByte((uint8_t)type_);
+	writer.writeSigned(damage_);
+	writer.writeDouble(buff_.duration);
+	writer.writeByte((uint8_t)buff_.type);
+	writer.writeFloat(buff_.strength);
+}
+
+BulletDamageComponent BulletDamageComponent::load(BinaryReader & reader)
+{
+	const uint8_t type = reader.readByte();
+	const int32_t damage = (int32_t)reader.readSigned();
+	const double duration = reader.readDouble();
+	const uint8_t buffType = reader.readByte();
+	const float strength = reader.readFloat();
+	if (type > (uint8_t)Type::BUFF || buffType > (uint8_t)CreepBuff::Type::BUFF_VULNERABILITY)
+		throw std::runtime_error("Saved Bullet has an unknown type");
+
+	return BulletDamageComponent((Type)type, damage, CreepBuff(duration, (CreepBuff::Type)buffType, strength));
 }
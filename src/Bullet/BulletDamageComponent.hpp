@@ -3,37 +3,41 @@
 #ifndef TDF_BULLET_DAMAGE_COMPONENT_HPP
 #define TDF_BULLET_DAMAGE_COMPONENT_HPP
 
-#include <memory>
+#include <cstdint>
+#include "../BinaryStream.hpp"
 #include "../Creep/Buff.hpp"
 
-class Creep;
+class CreepStore;
 
-//! A component for Bullet implementing the damage
-class BulletDamageComponent {
+//! \brief A component for Bullet implementing the damage.
+//! Kept by value inside the Bullet, so that creating one does not allocate.
+class BulletDamageComponent
+{
 public:
-	virtual void damage(std::shared_ptr<Creep> creep) const = 0;
-};
+	enum class Type : uint8_t
+	{
+		//! Bullet which does normal damage
+		SIMPLE,
+		//! Bullet which gives buffs
+		BUFF
+	};
 
-//! Bullet which does normal damage
-class BulletSimpleDamageComponent final : public BulletDamageComponent
-{
 private:
+	Type type_;
 	int32_t damage_;
+	CreepBuff buff_;
+
+	BulletDamageComponent(Type type, int32_t damage, CreepBuff buff);
 
 public:
-	BulletSimpleDamageComponent(int32_t damage);
-	virtual void damage(std::shared_ptr<Creep> creep) const override;
-};
+	static BulletDamageComponent simple(int32_t damage);
+	static BulletDamageComponent buff(CreepBuff buff);
 
-//! Bullet which gives buffs
-class BulletBuffDamageComponent final : public BulletDamageComponent
-{
-private:
-	CreepBuff buff_;
+	//! Damages the Creep at the given index of the store.
+	void damage(CreepStore & creeps, uint32_t index) const;
 
-public:
-	BulletBuffDamageComponent(CreepBuff buff);
-	virtual void damage(std::shared_ptr<Creep> creep) const override;
+	void save(BinaryWriter & writer) const;
+	static BulletDamageComponent load(BinaryReader & reader);
 };
 
 #endif // TDF_BULLET_DAMAGE_COMPONENT_HPP
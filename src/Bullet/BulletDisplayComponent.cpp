@@ -1,32 +1,33 @@
+#include "Bullet.hpp"
 #include "BulletDisplayComponent.hpp"
-#include "BulletMovementComponent.hpp"
 
 BulletSimpleDisplayComponent::BulletSimpleDisplayComponent(
 	float radius,
-	BulletMovementComponent & movementComponent)
+	const EntityRegistry<Bullet> & bullets, Handle<Bullet> bullet)
 	: circleShape_(radius)
-	, movementComponent_(movementComponent)
+	, bullets_(bullets)
+	, bullet_(bullet)
 {
 	circleShape_.setOrigin(radius, radius);
 	circleShape_.setFillColor(sf::Color::Red);
 }
 
-void BulletSimpleDisplayComponent::render(sf::RenderTarget & target)
+void BulletSimpleDisplayComponent::render(SpriteBatch & batch)
 {
-	circleShape_.setPosition(movementComponent_.getPosition());
-	target.draw(circleShape_);
+	circleShape_.setPosition(bullets_.find(bullet_)->getPosition());
+	batch.add(circleShape_);
 }
 
-BulletLaserDisplayComponent::BulletLaserDisplayComponent(BulletMovementComponent &movementComponent)
-		: movementComponent_(movementComponent)
+BulletLaserDisplayComponent::BulletLaserDisplayComponent(const EntityRegistry<Bullet> & bullets, Handle<Bullet> bullet)
+		: bullets_(bullets)
+		, bullet_(bullet)
 {
 }
 
-void BulletLaserDisplayComponent::render(sf::RenderTarget & target)
+void BulletLaserDisplayComponent::render(SpriteBatch & batch)
 {
-	sf::Vertex v[] = {
-			sf::Vertex(movementComponent_.getPosition(), sf::Color(255, 0, 0)),
-			sf::Vertex(movementComponent_.getTargetPosition(), sf::Color(255, 0, 0))
-	};
-	target.draw(v, 2, sf::PrimitiveType::Lines);
+	const Bullet * bullet = bullets_.find(bullet_);
+	batch.addLine(
+		sf::Vertex(bullet->getPosition(), sf::Color(255, 0, 0)),
+		sf::Vertex(bullet->getTargetPosition(), sf::Color(255, 0, 0)));
 }
\ No newline at end of file
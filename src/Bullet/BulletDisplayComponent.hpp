@@ -3,9 +3,10 @@
 #ifndef TDF_BULLET_DISPLAY_COMPONENT_HPP
 #define TDF_BULLET_DISPLAY_COMPONENT_HPP
 
+#include "../EntityRegistry.hpp"
 #include "../Renderable.hpp"
 
-class BulletMovementComponent;
+class Bullet;
 
 //! A component for Bullet implementing the look of a Bullet.
 class BulletDisplayComponent : public Renderable {};
@@ -15,24 +16,26 @@ class BulletSimpleDisplayComponent final : public BulletDisplayComponent
 {
 private:
 	sf::CircleShape circleShape_;
-	BulletMovementComponent & movementComponent_;
+	const EntityRegistry<Bullet> & bullets_;
+	Handle<Bullet> bullet_;
 
 public:
 	BulletSimpleDisplayComponent(
 		float radius,
-		BulletMovementComponent & movementComponent);
-	virtual void render(sf::RenderTarget & target) override;
+		const EntityRegistry<Bullet> & bullets, Handle<Bullet> bullet);
+	virtual void render(SpriteBatch & batch) override;
 };
 
 //! A very simple look for Bullet that looks like laser.
 class BulletLaserDisplayComponent final : public BulletDisplayComponent
 {
 private:
-	BulletMovementComponent & movementComponent_;
+	const EntityRegistry<Bullet> & bullets_;
+	Handle<Bullet> bullet_;
 
 public:
-	BulletLaserDisplayComponent(BulletMovementComponent &movementComponent);
-	virtual void render(sf::RenderTarget & target) override;
+	BulletLaserDisplayComponent(const EntityRegistry<Bullet> & bullets, Handle<Bullet> bullet);
+	virtual void render(SpriteBatch & batch) override;
 };
 
 #endif // TDF_BULLET_DISPLAY_COMPONENT_HPP
@@ -1,52 +1,60 @@
-#include "../MakeUnique.hpp"
+#include <algorithm>
+#include <stdexcept>
 #include "Bullet.hpp"
-#include "BulletDisplayComponent.hpp"
 #include "BulletMovementComponent.hpp"
 #include "BulletDamageComponent.hpp"
 #include "BulletFactory.hpp"
 #include "../Level.hpp"
 
-std::shared_ptr<Bullet> BulletFactory::innerCreateBullet(
+//! Bullets refer to their type by its index here, so new types go at the end.
+static const std::vector<std::string> bulletNames_ = {
+	"GenericBullet", "LaserBullet", "SlownessBullet", "WeaknessBullet"
+};
+
+Bullet BulletFactory::innerCreateBullet(
 	const std::string & bulletName) const
 {
+	typedef BulletMovementComponent::Type Movement;
+	auto & creeps = levelInstance_.getCreeps();
+	const uint8_t typeId = (uint8_t)(std::find(bulletNames_.begin(), bulletNames_.end(), bulletName) - bulletNames_.begin());
+
 	if (bulletName == "GenericBullet") {
-		auto movement = std::make_unique<BulletTimedMovementComponent>(
-			std::make_unique<BulletSimpleDamageComponent>(20), 1.f, target_, position_);
-		auto display = std::make_unique<BulletSimpleDisplayComponent>(0.0625f, *movement.get());
-		return std::make_shared<Bullet>(std::move(movement), std::move(display));
+		return Bullet(BulletMovementComponent(Movement::TIMED,
+			BulletDamageComponent::simple(20), 1.f, creeps, target_, position_), typeId);
 	}
 
 	if (bulletName == "LaserBullet") {
-		auto movement = std::make_unique<BulletLaserMovementComponent>(
-			std::make_unique<BulletSimpleDamageComponent>(10), 0.1f, target_, position_);
-		auto display = std::make_unique<BulletLaserDisplayComponent>(*movement.get());
-		return std::make_shared<Bullet>(std::move(movement), std::move(display));
+		return Bullet(BulletMovementComponent(Movement::LASER,
+			BulletDamageComponent::simple(10), 0.1f, creeps, target_, position_), typeId);
 	}
 
 	if (bulletName == "SlownessBullet") {
-		auto movement = std::make_unique<BulletTimedMovementComponent>(
-				std::make_unique<BulletBuffDamageComponent>(CreepBuff(5, CreepBuff::Type::BUFF_SPEED, -20)), 1.0f, target_, position_);
-		auto display = std::make_unique<BulletSimpleDisplayComponent>(0.25f, *movement.get());
-		return std::make_shared<Bullet>(std::move(movement), std::move(display));
+		return Bullet(BulletMovementComponent(Movement::TIMED,
+			BulletDamageComponent::buff(CreepBuff(5, CreepBuff::Type::BUFF_SPEED, -20)), 1.0f, creeps, target_, position_), typeId);
 	}
 
 	if (bulletName == "WeaknessBullet") {
-		auto movement = std::make_unique<BulletTimedMovementComponent>(
-				std::make_unique<BulletBuffDamageComponent>(CreepBuff(10, CreepBuff::Type::BUFF_VULNERABILITY, 500)), 1.0f, target_, position_);
-		auto display = std::make_unique<BulletSimpleDisplayComponent>(0.25f, *movement.get());
-		return std::make_shared<Bullet>(std::move(movement), std::move(display));
+		return Bullet(BulletMovementComponent(Movement::TIMED,
+			BulletDamageComponent::buff(CreepBuff(10, CreepBuff::Type::BUFF_VULNERABILITY, 500)), 1.0f, creeps, target_, position_), typeId);
 	}
 
 	throw std::runtime_error("Unknown Bullet type: " + bulletName);
 }
 
-BulletFactory::BulletFactory(std::shared_ptr<LevelInstance> levelInstance, sf::Vector2f position)
+BulletFactory::BulletFactory(LevelInstance & levelInstance, sf::Vector2f position)
 	: levelInstance_(levelInstance)
 	, position_(position)
 {}
 
+const std::string & BulletFactory::getBulletName(uint8_t typeId)
+{
+	if (typeId >= bulletNames_.size())
+		throw std::runtime_error("Unknown Bullet type id: " + std::to_string(typeId));
+	return bulletNames_[typeId];
+}
+
 void BulletFactory::createBullet(
 	const std::string & bulletName)
 {
-	levelInstance_->registerBullet(innerCreateBullet(bulletName));
+	levelInstance_.registerBullet(innerCreateBullet(bulletName), bulletName);
 }
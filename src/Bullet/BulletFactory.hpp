@@ -4,31 +4,33 @@
 #define TDF_BULLET_FACTORY_HPP
 
 #include <memory>
+#include <string>
 #include <vector>
 #include <SFML/System.hpp>
 
+#include "../Creep/CreepStore.hpp"
+
 class Bullet;
-class Creep;
 class LevelInstance;
 
 //! Its sole purpose is to create bullets.
 class BulletFactory
 {
 private:
-	std::shared_ptr<LevelInstance> levelInstance_;
-	std::shared_ptr<Creep> target_;
+	LevelInstance & levelInstance_;
+	CreepHandle target_;
 	const sf::Vector2f position_;
 
-	std::shared_ptr<Bullet> innerCreateBullet(
+	Bullet innerCreateBullet(
 		const std::string & bulletName) const;
 
 public:
 	BulletFactory(
-		std::shared_ptr<LevelInstance> levelInstance,
+		LevelInstance & levelInstance,
 		sf::Vector2f position);
 
 	//! Sets the Creep which will be targeted by created Bullets.
-	inline void setTarget(const std::shared_ptr<Creep> & target)
+	inline void setTarget(CreepHandle target)
 	{
 		target_ = target;
 	}
@@ -36,6 +38,9 @@ public:
 	//! Creates bullet directed at target_.
 	void createBullet(const std::string & bulletName);
 
+	//! Returns the name of the type of Bullets with given id.
+	static const std::string & getBulletName(uint8_t typeId);
+
 	//! Alternative for BulletFactory::createBullet.
 	inline void shoot(const std::string & bulletName)
 	{
@@ -1,107 +1,85 @@
 #include <algorithm>
-#include <memory>
+#include <stdexcept>
 #include <SFML/System.hpp>
 #include "BulletMovementComponent.hpp"
-#include "BulletDamageComponent.hpp"
-#include "../Creep/Creep.hpp"
 
-BulletTimedMovementComponent::BulletTimedMovementComponent(
-	std::unique_ptr<BulletDamageComponent> damageComponent,
+BulletMovementComponent::BulletMovementComponent(
+	Type type,
+	BulletDamageComponent damageComponent,
 	float time,
-	const std::shared_ptr<Creep> & target,
+	CreepStore & creeps,
+	CreepHandle target,
 	sf::Vector2f startingPosition)
-    : damageComponent_(std::move(damageComponent))
+	: type_(type)
+	, damageComponent_(damageComponent)
 	, position_(startingPosition)
 	, timeToHit_(time)
+	, creeps_(&creeps)
 	, target_(target)
 {}
 
-void BulletTimedMovementComponent::update(sf::Time dt)
+bool BulletMovementComponent::fly(sf::Time dt)
 {
-	auto lockedTarget = target_.lock();
-	if (!lockedTarget)
-		return;
+	if (!creeps_->contains(target_))
+		return false;
 
+	const uint32_t index = creeps_->indexOf(target_);
 	const float nextTime = std::max(timeToHit_ - dt.asSeconds(), 0.f);
-	const float factor = (nextTime == 0.f) ? 0.f : (nextTime / timeToHit_);
-	const auto creepPosition = lockedTarget->getPosition();
 
-	position_ = creepPosition + factor * (position_ - creepPosition);
+	if (type_ == Type::TIMED) {
+		const float factor = (nextTime == 0.f) ? 0.f : (nextTime / timeToHit_);
+		const auto creepPosition = creeps_->getPosition(index);
+		position_ = creepPosition + factor * (position_ - creepPosition);
+	}
+
 	timeToHit_ = nextTime;
+	return nextTime == 0.f;
+}
 
-	if (nextTime == 0.f) {
-		damageComponent_->damage(lockedTarget);
-		target_.reset();
-	}
+void BulletMovementComponent::hit()
+{
+	damageComponent_.damage(*creeps_, creeps_->indexOf(target_));
+	target_ = CreepHandle();
 }
 
-sf::Vector2f BulletTimedMovementComponent::getPosition() const
+sf::Vector2f BulletMovementComponent::getPosition() const
 {
 	return position_;
 }
 
-bool BulletTimedMovementComponent::isAlive() const
+bool BulletMovementComponent::isAlive() const
 {
 	if (timeToHit_ <= 0.f)
 		return false;
 
-	auto lockedTarget = target_.lock();
-	return lockedTarget && lockedTarget->isAlive();
+	return creeps_->contains(target_) && creeps_->isAlive(creeps_->indexOf(target_));
 }
 
-sf::Vector2f BulletTimedMovementComponent::getTargetPosition() const
+sf::Vector2f BulletMovementComponent::getTargetPosition() const
 {
-	auto lockedTarget = target_.lock();
-	if (!lockedTarget)
+	if (!creeps_->contains(target_))
 		return position_;
-	return lockedTarget->getPosition();
+	return creeps_->getPosition(creeps_->indexOf(target_));
 }
 
-BulletLaserMovementComponent::BulletLaserMovementComponent(
-		std::unique_ptr<BulletDamageComponent> damageComponent,
-		float time,
-		const std::shared_ptr<Creep> & target,
-		sf::Vector2f startingPosition)
-		: damageComponent_(std::move(damageComponent))
-		, position_(startingPosition)
-		, timeToHit_(time)
-		, target_(target)
-{}
-
-void BulletLaserMovementComponent::update(sf::Time dt)
+void BulletMovementComponent::save(BinaryWriter & writer) const
 {
-	auto lockedTarget = target_.lock();
-	if (!lockedTarget)
-		return;
-
-	const float nextTime = std::max(timeToHit_ - dt.asSeconds(), 0.f);
-
-	timeToHit_ = nextTime;
-
-	if (nextTime == 0.f) {
-		damageComponent_->damage(lockedTarget);
-		target_.reset();
-	}
-}
-
-sf::Vector2f BulletLaserMovementComponent::getPosition() const
-{
-	return position_;
-}
-
-bool BulletLaserMovementComponent::isAlive() const
-{
-	if (timeToHit_ <= 0.f)
-		return false;
-
-	auto lockedTarget = target_.lock();
-	return lockedTarget && lockedTarget->isAlive();
+	writer.writeByte((uint8_t)type_);
+	damageComponent_.save(writer);
+	writer.writeVector(position_);
+	writer.writeFloat(timeToHit_);
+	target_.save(writer);
 }
 
-sf::Vector2f BulletLaserMovementComponent::getTargetPosition() const
+BulletMovementComponent BulletMovementComponent::load(BinaryReader & reader, const CreepStore & loaded, CreepStore & creeps)
 {
-	auto lockedTarget = target_.lock();
-	if (!lockedTarget)
-		return position_;
-	return lockedTarget->getPosition();
+	const uint8_t type = reader.readByte();
+	if (type > (uint8_t)Type::LASER)
+		throw std::runtime_error("Saved Bullet has an unknown type");
+	const auto damageComponent = BulletDamageComponent::load(reader);
+	const sf::Vector2f position = reader.readVector2f();
+	const float timeToHit = reader.readFloat();
+	const CreepHandle target = loaded.loadHandle(reader);
+
+	return BulletMovementComponent((Type)type, damageComponent, timeToHit, creeps, target, position);
 }
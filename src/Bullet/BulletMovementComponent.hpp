@@ -3,67 +3,57 @@
 #ifndef TDF_BULLET_MOVEMENT_COMPONENT_HPP
 #define TDF_BULLET_MOVEMENT_COMPONENT_HPP
 
-#include <memory>
+#include <cstdint>
 #include <SFML/System.hpp>
 
-class Creep;
-class BulletDamageComponent;
+#include "../Creep/CreepStore.hpp"
+#include "BulletDamageComponent.hpp"
 
-//! A component for Bullet implementing movement logic.
+//! \brief A component for Bullet implementing movement logic.
+//! Kept by value inside the Bullet, so that creating one does not allocate.
 class BulletMovementComponent
 {
 public:
-	virtual ~BulletMovementComponent() {}
+	enum class Type : uint8_t
+	{
+		//! A bullet which always hits the target after a given delay.
+		TIMED,
+		//! A bullet which does not move and hits the target after a given delay.
+		LASER
+	};
 
-	//! Updates position of the Bullet.
-	virtual void update(sf::Time dt) = 0;
-
-	virtual sf::Vector2f getPosition() const = 0;
-	virtual sf::Vector2f getTargetPosition() const = 0;
-	virtual bool isAlive() const = 0;
-};
-
-//! Implements a bullet which always hits the target after a given delay.
-class BulletTimedMovementComponent final : public BulletMovementComponent
-{
 private:
-	std::unique_ptr<BulletDamageComponent> damageComponent_;
+	Type type_;
+	BulletDamageComponent damageComponent_;
 	sf::Vector2f position_;
 	float timeToHit_;
-	std::weak_ptr<Creep> target_;
+	CreepStore * creeps_;
+	CreepHandle target_;
 
 public:
-	BulletTimedMovementComponent(
-		std::unique_ptr<BulletDamageComponent> damageComponent,
+	BulletMovementComponent(
+		Type type,
+		BulletDamageComponent damageComponent,
 		float time,
-		const std::shared_ptr<Creep> & target,
+		CreepStore & creeps,
+		CreepHandle target,
 		sf::Vector2f startingPosition);
-	void update(sf::Time dt) override;
-	virtual sf::Vector2f getPosition() const override;
-	virtual sf::Vector2f getTargetPosition() const override;
-	virtual bool isAlive() const override;
-};
 
+	void save(BinaryWriter & writer) const;
+	//! \brief Reads a saved component. Its target is checked against the Creeps
+	//! loaded with it, which are to replace those of the store it flies in.
+	static BulletMovementComponent load(BinaryReader & reader, const CreepStore & loaded, CreepStore & creeps);
 
-//! Implements a bullet which does not move and hits the target after a given delay.
-class BulletLaserMovementComponent final : public BulletMovementComponent
-{
-private:
-	std::unique_ptr<BulletDamageComponent> damageComponent_;
-	sf::Vector2f position_;
-	float timeToHit_;
-	std::weak_ptr<Creep> target_;
+	//! \brief Updates position of the Bullet, returns if it reached its target.
+	//! Only reads the Creeps, so Bullets may fly in parallel.
+	bool fly(sf::Time dt);
 
-public:
-	BulletLaserMovementComponent(
-		std::unique_ptr<BulletDamageComponent> damageComponent,
-		float time,
-		const std::shared_ptr<Creep> & target,
-		sf::Vector2f startingPosition);
-	void update(sf::Time dt) override;
-	virtual sf::Vector2f getPosition() const override;
-	virtual sf::Vector2f getTargetPosition() const override;
-	virtual bool isAlive() const override;
+	//! Damages the target, once fly returned true.
+	void hit();
+
+	sf::Vector2f getPosition() const;
+	sf::Vector2f getTargetPosition() const;
+	bool isAlive() const;
 };
 
 #endif // TDF_BULLET_MOVEMENT_COMPONENT_HPP
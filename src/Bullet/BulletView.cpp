@@ -0,0 +1,53 @@
+#include <algorithm>
+#include <stdexcept>
+#include "../MakeUnique.hpp"
+#include "Bullet.hpp"
+#include "BulletView.hpp"
+
+BulletView::BulletView(
+	const EntityRegistry<Bullet> & bullets, Handle<Bullet> bullet,
+	const std::string & bulletName)
+	: bullets_(bullets)
+	, bullet_(bullet)
+	, previousPosition_(bullets.find(bullet)->getPosition())
+	, position_(previousPosition_)
+{
+	if (bulletName == "GenericBullet")
+		displayComponent_ = std::make_unique<BulletSimpleDisplayComponent>(0.0625f, bullets, bullet);
+	else if (bulletName == "LaserBullet")
+		displayComponent_ = std::make_unique<BulletLaserDisplayComponent>(bullets, bullet);
+	else if (bulletName == "SlownessBullet" || bulletName == "WeaknessBullet")
+		displayComponent_ = std::make_unique<BulletSimpleDisplayComponent>(0.25f, bullets, bullet);
+	else
+		throw std::runtime_error("Unknown Bullet type: " + bulletName);
+}
+
+sf::FloatRect BulletView::getBounds() const
+{
+	const Bullet * bullet = bullets_.find(bullet_);
+	const sf::Vector2f from = bullet->getPosition();
+	const sf::Vector2f to = bullet->getTargetPosition();
+	const sf::Vector2f topLeft(std::min(from.x, to.x), std::min(from.y, to.y));
+	const sf::Vector2f bottomRight(std::max(from.x, to.x), std::max(from.y, to.y));
+	return sf::FloatRect(topLeft, bottomRight - topLeft);
+}
+
+void BulletView::update(const sf::Time & /*dt*/)
+{
+	previousPosition_ = position_;
+	position_ = bullets_.find(bullet_)->getPosition();
+}
+
+void BulletView::render(SpriteBatch & batch)
+{
+	displayComponent_->render(batch);
+}
+
+void BulletView::render(SpriteBatch & batch, float interpolation)
+{
+	sf::Transform transform;
+	transform.translate((previousPosition_ - position_) * (1.f - interpolation));
+	batch.setTransform(transform);
+	displayComponent_->render(batch);
+	batch.setTransform(sf::Transform::Identity);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#ifndef TDF_BULLET_VIEW_HPP
+#define TDF_BULLET_VIEW_HPP
+
+#include <memory>
+#include <string>
+#include <SFML/Graphics.hpp>
+
+#include "../EntityRegistry.hpp"
+#include "../Renderable.hpp"
+#include "BulletDisplayComponent.hpp"
+
+class Bullet;
+
+//! The visual side of a Bullet.
+class BulletView final : public Renderable
+{
+private:
+	const EntityRegistry<Bullet> & bullets_;
+	Handle<Bullet> bullet_;
+	//! Positions after the last two ticks, to draw the Bullet in between.
+	sf::Vector2f previousPosition_, position_;
+	std::unique_ptr<BulletDisplayComponent> displayComponent_;
+
+public:
+	BulletView(
+		const EntityRegistry<Bullet> & bullets, Handle<Bullet> bullet,
+		const std::string & bulletName);
+
+	//! Returns if the Bullet has hit or lost its target.
+	inline bool isExpired() const
+	{
+		return !bullets_.contains(bullet_);
+	}
+
+	//! Returns a rectangle spanning the Bullet and its target.
+	sf::FloatRect getBounds() const;
+
+	virtual void update(const sf::Time & dt) override;
+	virtual void render(SpriteBatch & batch) override;
+	void render(SpriteBatch & batch, float interpolation);
+};
+
+#endif // TDF_BULLET_VIEW_HPP
@@ -3,9 +3,17 @@
 #ifndef TDF_CONSTANTS_HPP
 #define TDF_CONSTANTS_HPP
 
+#include <cstdint>
+
 namespace Constants
 {
+	//! Length of a simulation tick.
 	static const float SECONDS_PER_FRAME = 1.f / 60.f;
+	//! \brief How many ticks the game catches up with in one rendered frame.
+	//! If it falls further behind, it slows down instead.
+	static const int MAX_TICKS_PER_FRAME = 8;
+	//! Ticks between keyframes of recorded input, a minute of game time.
+	static const uint64_t KEYFRAME_INTERVAL = 60 * 60;
 }
 
 #endif // TDF_CONSTANTS_HPP
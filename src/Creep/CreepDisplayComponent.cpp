@@ -1,13 +1,13 @@
 #include "CreepDisplayComponent.hpp"
-#include "CreepWalkComponent.hpp"
 
 const sf::Time CreepDotDisplayComponent::animation_duration_ = sf::milliseconds(1000);
 
 CreepDotDisplayComponent::CreepDotDisplayComponent(
-	const CreepWalkComponent & walkComponent,
+	const CreepStore & creeps, CreepHandle creep,
 	float radius, const sf::Texture& texture, const thor::FrameAnimation& animation)
 	: radius_(radius)
-	, walkComponent_(walkComponent)
+	, creeps_(creeps)
+	, creep_(creep)
 	, animation_(animation)
 {
 	sprite_.setTexture(texture);
@@ -15,20 +15,20 @@ CreepDotDisplayComponent::CreepDotDisplayComponent(
 	sprite_.setScale(1.f/32.f, 1.f/32.f);
 }
 
-void CreepDotDisplayComponent::render(sf::RenderTarget & target)
+void CreepDotDisplayComponent::render(SpriteBatch & batch)
 {
-	sf::Vector2f pos = walkComponent_.getPosition();
+	sf::Vector2f pos = creeps_.getPosition(creeps_.indexOf(creep_));
 	pos.x -= 0.5f;
 	pos.y -= 0.5f;
 
 	animation_(sprite_, (float)animation_time_.asMilliseconds() / (float)animation_duration_.asMilliseconds());
 	sprite_.setPosition(pos);
-	target.draw(sprite_);
+	batch.add(sprite_);
 }
 
 bool CreepDotDisplayComponent::isHit(sf::Vector2f point) const
 {
-	const auto diff = point - walkComponent_.getPosition();
+	const auto diff = point - creeps_.getPosition(creeps_.indexOf(creep_));
 	return diff.x * diff.x + diff.y * diff.y <= radius_ * radius_;
 }
 
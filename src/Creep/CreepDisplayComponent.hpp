@@ -8,8 +8,7 @@
 #include <Thor/Animations.hpp>
 
 #include "../Renderable.hpp"
-
-class CreepWalkComponent;
+#include "CreepStore.hpp"
 
 //! Component of the Creep implementing its look.
 class CreepDisplayComponent : public Renderable {};
@@ -22,7 +21,8 @@ class CreepDotDisplayComponent final : public CreepDisplayComponent
 {
 private:
 	float radius_;
-	const CreepWalkComponent & walkComponent_;
+	const CreepStore & creeps_;
+	CreepHandle creep_;
 	thor::FrameAnimation animation_;
 	sf::Sprite sprite_;
 	sf::Time animation_time_;
@@ -30,9 +30,9 @@ private:
 	static const sf::Time animation_duration_;
 
 public:
-	CreepDotDisplayComponent(const CreepWalkComponent & walkComponent, 
+	CreepDotDisplayComponent(const CreepStore & creeps, CreepHandle creep,
 		float radius, const sf::Texture &texture, const thor::FrameAnimation& animation);
-	virtual void render(sf::RenderTarget & target) override;
+	virtual void render(SpriteBatch & batch) override;
 	virtual bool isHit(sf::Vector2f point) const override;
 	virtual void update(const sf::Time &dt) override;
 };
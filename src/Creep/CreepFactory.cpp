@@ -1,32 +1,15 @@
-#include <memory>
+#include <stdexcept>
 #include <string>
-#include "../MakeUnique.hpp"
-#include "Creep.hpp"
 #include "CreepFactory.hpp"
-#include "CreepLifeDisplayComponent.hpp"
 
-std::shared_ptr<Creep> CreepFactory::createCreep(
+CreepHandle CreepFactory::createCreep(
+	CreepStore & store,
 	const std::string & typeName,
 	int32_t life, int32_t bounty,
-	sf::Vector2i position, Game &game)
+	sf::Vector2i position)
 {
-	if (typeName == "GenericCreep") {
-		auto walk = std::make_unique<CreepGridWalkComponent>(position);
-		auto dotDisplay = std::make_unique<CreepDotDisplayComponent>(*walk.get(), 0.125f,
-			game.getTexture("Creep"), game.getAnimation("Creep"));
-
-		auto lifeDisplay = std::make_unique<CreepLifeDisplayComponent>(
-			sf::Vector2f(0.f, 0.5f), sf::Vector2f(0.8f, 0.2f), true);
-		auto lifeDisplayDirect = lifeDisplay.get();
-
-		auto compositeDisplay = std::make_unique<CreepCompositeDisplayComponent>();
-		compositeDisplay->addChild(std::move(dotDisplay));
-		compositeDisplay->addChild(std::move(lifeDisplay));
-
-		auto ret = std::make_shared<Creep>(life, bounty, std::move(walk), std::move(compositeDisplay));
-		lifeDisplayDirect->setOwner(ret.get());
-		return ret;
-	}
+	if (typeName == "GenericCreep")
+		return store.add(typeName, life, bounty, position);
 
 	throw std::runtime_error("Unknown Creep type: " + typeName);
 }
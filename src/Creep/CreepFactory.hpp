@@ -3,16 +3,20 @@
 #ifndef TDF_CREEP_FACTORY_HPP
 #define TDF_CREEP_FACTORY_HPP
 
-class Game;
+#include <string>
+#include <SFML/System.hpp>
+
+#include "CreepStore.hpp"
 
 //! Its sole function is to create creeps.
 class CreepFactory
 {
 public:
-	std::shared_ptr<Creep> createCreep(
+	CreepHandle createCreep(
+		CreepStore & store,
 		const std::string & typeName,
 		int32_t life, int32_t bounty,
-		sf::Vector2i position, Game &game);
+		sf::Vector2i position);
 };
 
 #endif // TDF_CREEP_FACTORY_HPP
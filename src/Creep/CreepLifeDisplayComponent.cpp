@@ -1,5 +1,4 @@
 #include <cassert>
-#include "Creep.hpp"
 #include "CreepLifeDisplayComponent.hpp"
 
 CreepLifeDisplayComponent::CreepLifeDisplayComponent(
@@ -7,36 +6,39 @@ CreepLifeDisplayComponent::CreepLifeDisplayComponent(
 	: size_(size)
 	, hideOnFull_(hideOnFull)
 {
-	owner_ = nullptr;
+	creeps_ = nullptr;
 	shape_.setOrigin(0.5f * size - offset);
 	shape_.setFillColor(sf::Color::Green);
 	backgroundShape_.setOrigin(0.5f * size - offset);
 	backgroundShape_.setFillColor(sf::Color::Blue);
 }
 
-void CreepLifeDisplayComponent::setOwner(Creep * owner)
+void CreepLifeDisplayComponent::setOwner(const CreepStore & creeps, CreepHandle owner)
 {
+	creeps_ = &creeps;
 	owner_ = owner;
 }
 
-void CreepLifeDisplayComponent::render(sf::RenderTarget & target)
+void CreepLifeDisplayComponent::render(SpriteBatch & batch)
 {
-	assert(owner_ != nullptr);
+	assert(creeps_ != nullptr);
 	hideOnFull_ = false;
 
-	const auto life = std::max(owner_->getLife(), 0);
-	const auto maxLife = owner_->getMaxLife();
+	const uint32_t index = creeps_->indexOf(owner_);
+	const auto life = std::max(creeps_->getLife(index), 0);
+	const auto maxLife = creeps_->getMaxLife(index);
+	const auto position = creeps_->getPosition(index);
 
 	if (hideOnFull_ && (life == maxLife))
 		return;
 
 	const float percentage = (float)life / (float)maxLife;
 
-	shape_.setPosition(owner_->getPosition());
+	shape_.setPosition(position);
 	shape_.setSize({ size_.x * percentage, size_.y });
-	backgroundShape_.setPosition(owner_->getPosition()
+	backgroundShape_.setPosition(position
 				- sf::Vector2f(0.1f, 0.1f));
 	backgroundShape_.setSize({ size_.x + 0.2f , size_.y + 0.2f });
-	target.draw(backgroundShape_);
-	target.draw(shape_);
+	batch.add(backgroundShape_);
+	batch.add(shape_);
 }
@@ -4,14 +4,13 @@
 #define TDF_CREEP_LIFE_DISPLAY_COMPONENT
 
 #include "CreepDisplayComponent.hpp"
-
-class Creep;
-class CreepWalkComponent;
+#include "CreepStore.hpp"
 
 class CreepLifeDisplayComponent final : public CreepDisplayComponent
 {
 private:
-	Creep * owner_;
+	const CreepStore * creeps_;
+	CreepHandle owner_;
 	sf::RectangleShape shape_;
 	sf::RectangleShape backgroundShape_;
 	sf::Vector2f size_;
@@ -19,8 +18,8 @@ private:
 
 public:
 	CreepLifeDisplayComponent(sf::Vector2f offset, sf::Vector2f size, bool hideOnFull);
-	void setOwner(Creep * owner);
-	virtual void render(sf::RenderTarget & target) override;
+	void setOwner(const CreepStore & creeps, CreepHandle owner);
+	virtual void render(SpriteBatch & batch) override;
 };
 
 #endif // TDF_CREEP_LIFE_DISPLAY_COMPONENT
@@ -1,32 +1,299 @@
+#include <algorithm>
+#include <cmath>
 #include "CreepQueryService.hpp"
 
-CreepVectorQueryService::CreepVectorQueryService(const std::vector<std::shared_ptr<Creep>> & creeps)
+std::vector<CreepQueryService::candidate_t> & CreepQueryService::getCandidates()
+{
+	static thread_local std::vector<candidate_t> candidates;
+	candidates.clear();
+	return candidates;
+}
+
+void CreepQueryService::offerCandidate(std::vector<candidate_t> & candidates, candidate_t candidate, size_t maxCount)
+{
+	if (maxCount == 0)
+		return;
+	if (candidates.size() == maxCount && !(candidate < candidates.back()))
+		return;
+
+	const size_t position = std::upper_bound(candidates.begin(), candidates.end(), candidate)
+		- candidates.begin();
+	if (candidates.size() == maxCount)
+		candidates.pop_back();
+	candidates.insert(candidates.begin() + position, candidate);
+}
+
+CreepQueryService::CreepQueryService(
+	const CreepStore & creeps,
+	const NavigationProvider<sf::Vector2i> & navigation)
 	: creeps_(creeps)
+	, navigation_(navigation)
 {}
 
-std::shared_ptr<Creep> CreepVectorQueryService::getClosestCreep(
+size_t CreepQueryService::writeCandidates(const std::vector<candidate_t> & candidates, CreepHandle * result) const
+{
+	for (size_t i = 0; i < candidates.size(); ++i)
+		result[i] = creeps_.handleAt(candidates[i].index);
+	return candidates.size();
+}
+
+CreepVectorQueryService::CreepVectorQueryService(
+	const CreepStore & creeps,
+	const NavigationProvider<sf::Vector2i> & navigation)
+	: CreepQueryService(creeps, navigation)
+{}
+
+template<typename F>
+void CreepVectorQueryService::forEachCreepInRange(sf::Vector2f center, float range, F f) const
+{
+	const auto & positions = creeps_.getPositions();
+	const float sqRange = range * range;
+	for (uint32_t i = 0; i < (uint32_t)positions.size(); ++i) {
+		const auto d = positions[i] - center;
+		const float sqDistance = d.x * d.x + d.y * d.y;
+		if (sqDistance < sqRange && !f(i, sqDistance))
+			return;
+	}
+}
+
+CreepHandle CreepVectorQueryService::getClosestCreep(
 	sf::Vector2f center,
-	float maxRange)
+	float maxRange) const
 {
-	if (creeps_.empty())
-		return nullptr;
+	const auto & positions = creeps_.getPositions();
+	if (positions.empty())
+		return CreepHandle();
 
-	auto sqDistanceTo = [&](std::shared_ptr<Creep> creep) -> float
+	auto sqDistanceTo = [&](sf::Vector2f position) -> float
 	{
-		auto d = creep->getPosition() - center;
+		auto d = position - center;
 		return d.x * d.x + d.y * d.y;
 	};
 
-	std::shared_ptr<Creep> closest = nullptr;
+	CreepHandle closest;
 	float smallestDistance = maxRange * maxRange;
 
-	for (const auto & creep : creeps_) {
-		const float newDistance = sqDistanceTo(creep);
+	for (uint32_t i = 0; i < (uint32_t)positions.size(); ++i) {
+		const float newDistance = sqDistanceTo(positions[i]);
 		if (smallestDistance > newDistance) {
 			smallestDistance = newDistance;
-			closest = creep;
+			closest = creeps_.handleAt(i);
 		}
 	}
 
 	return closest;
 }
+
+size_t CreepVectorQueryService::getCreepsInRange(
+	sf::Vector2f center, float range,
+	CreepHandle * result, size_t maxCount) const
+{
+	size_t count = 0;
+	if (maxCount == 0)
+		return count;
+
+	forEachCreepInRange(center, range, [&](uint32_t index, float) {
+		result[count++] = creeps_.handleAt(index);
+		return count < maxCount;
+	});
+	return count;
+}
+
+size_t CreepVectorQueryService::getClosestCreeps(
+	sf::Vector2f center, float range,
+	CreepHandle * result, size_t maxCount) const
+{
+	auto & candidates = getCandidates();
+	forEachCreepInRange(center, range, [&](uint32_t index, float sqDistance) {
+		offerCandidate(candidates, { sqDistance, index }, maxCount);
+		return true;
+	});
+	return writeCandidates(candidates, result);
+}
+
+size_t CreepVectorQueryService::getFurthestAlongPathCreeps(
+	sf::Vector2f center, float range,
+	CreepHandle * result, size_t maxCount) const
+{
+	auto & candidates = getCandidates();
+	forEachCreepInRange(center, range, [&](uint32_t index, float) {
+		offerCandidate(candidates, { creeps_.getDistanceToGoal(index, navigation_), index }, maxCount);
+		return true;
+	});
+	return writeCandidates(candidates, result);
+}
+
+CreepGridQueryService::CreepGridQueryService(
+	const CreepStore & creeps,
+	const NavigationProvider<sf::Vector2i> & navigation,
+	int32_t width, int32_t height)
+	: CreepQueryService(creeps, navigation)
+	, width_(width)
+	, height_(height)
+	, cellStart_(width * height + 1, 0)
+{}
+
+int32_t CreepGridQueryService::cellIndexOf(sf::Vector2f position) const
+{
+	// Cells are centered on integer coordinates
+	const int32_t x = std::max(0, std::min(width_ - 1, (int32_t)std::floor(position.x + 0.5f)));
+	const int32_t y = std::max(0, std::min(height_ - 1, (int32_t)std::floor(position.y + 0.5f)));
+	return y * width_ + x;
+}
+
+void CreepGridQueryService::rebuild()
+{
+	// Counting sort of Creeps by cell, stable with respect to creeps_
+	const auto & positions = creeps_.getPositions();
+	const uint32_t creepCount = (uint32_t)positions.size();
+	std::fill(cellStart_.begin(), cellStart_.end(), 0);
+	creepCells_.resize(creepCount);
+	entries_.resize(creepCount);
+
+	for (uint32_t i = 0; i < creepCount; ++i) {
+		creepCells_[i] = cellIndexOf(positions[i]);
+		++cellStart_[creepCells_[i] + 1];
+	}
+
+	for (size_t i = 1; i < cellStart_.size(); ++i)
+		cellStart_[i] += cellStart_[i - 1];
+
+	// Fill using the start of each cell as a cursor, which leaves it pointing
+	// at the start of the next cell, then shift starts back into place
+	for (uint32_t i = 0; i < creepCount; ++i) {
+		const auto slot = cellStart_[creepCells_[i]]++;
+		entries_[slot] = { positions[i], i };
+	}
+
+	for (size_t i = cellStart_.size() - 1; i > 0; --i)
+		cellStart_[i] = cellStart_[i - 1];
+	cellStart_[0] = 0;
+}
+
+CreepHandle CreepGridQueryService::getClosestCreep(
+	sf::Vector2f center,
+	float maxRange) const
+{
+	if (entries_.empty())
+		return CreepHandle();
+
+	// Clamp in floating point first, as the range may be infinite
+	auto clampCell = [](float v, int32_t size) -> int32_t {
+		return (int32_t)std::floor(std::max(0.f, std::min((float)(size - 1), v + 0.5f)));
+	};
+	const int32_t minX = clampCell(center.x - maxRange, width_);
+	const int32_t maxX = clampCell(center.x + maxRange, width_);
+	const int32_t minY = clampCell(center.y - maxRange, height_);
+	const int32_t maxY = clampCell(center.y + maxRange, height_);
+
+	float smallestDistance = maxRange * maxRange;
+	static const uint32_t NONE = std::numeric_limits<uint32_t>::max();
+	uint32_t closest = NONE;
+
+	for (int32_t y = minY; y <= maxY; ++y) {
+		// Distance from the center to the nearest point of this row of cells
+		const float dy = std::max(0.f, std::abs(center.y - (float)y) - 0.5f);
+		if (dy * dy > smallestDistance)
+			continue;
+
+		for (int32_t x = minX; x <= maxX; ++x) {
+			const float dx = std::max(0.f, std::abs(center.x - (float)x) - 0.5f);
+			if (dx * dx + dy * dy > smallestDistance)
+				continue;
+
+			const int32_t cell = y * width_ + x;
+			for (uint32_t i = cellStart_[cell]; i < cellStart_[cell + 1]; ++i) {
+				const auto & entry = entries_[i];
+				const auto d = entry.position - center;
+				const float newDistance = d.x * d.x + d.y * d.y;
+
+				// Prefer earlier Creeps on ties, as the linear scan does
+				if (smallestDistance > newDistance
+					|| (smallestDistance == newDistance && closest != NONE && entry.index < closest)) {
+					smallestDistance = newDistance;
+					closest = entry.index;
+				}
+			}
+		}
+	}
+
+	if (closest == NONE)
+		return CreepHandle();
+	return creeps_.handleAt(closest);
+}
+
+template<typename F>
+void CreepGridQueryService::forEachCreepInRange(sf::Vector2f center, float range, F f) const
+{
+	if (entries_.empty())
+		return;
+
+	auto clampCell = [](float v, int32_t size) -> int32_t {
+		return (int32_t)std::floor(std::max(0.f, std::min((float)(size - 1), v + 0.5f)));
+	};
+	const int32_t minX = clampCell(center.x - range, width_);
+	const int32_t maxX = clampCell(center.x + range, width_);
+	const int32_t minY = clampCell(center.y - range, height_);
+	const int32_t maxY = clampCell(center.y + range, height_);
+	const float sqRange = range * range;
+
+	for (int32_t y = minY; y <= maxY; ++y) {
+		const float dy = std::max(0.f, std::abs(center.y - (float)y) - 0.5f);
+		for (int32_t x = minX; x <= maxX; ++x) {
+			// Creeps outside of the level are clamped into border cells,
+			// so border cells can not be skipped by their distance
+			const bool border = x == 0 || y == 0 || x == width_ - 1 || y == height_ - 1;
+			const float dx = std::max(0.f, std::abs(center.x - (float)x) - 0.5f);
+			if (!border && dx * dx + dy * dy >= sqRange)
+				continue;
+
+			const int32_t cell = y * width_ + x;
+			for (uint32_t i = cellStart_[cell]; i < cellStart_[cell + 1]; ++i) {
+				const auto & entry = entries_[i];
+				const auto d = entry.position - center;
+				const float sqDistance = d.x * d.x + d.y * d.y;
+				if (sqDistance < sqRange && !f(entry.index, sqDistance))
+					return;
+			}
+		}
+	}
+}
+
+size_t CreepGridQueryService::getCreepsInRange(
+	sf::Vector2f center, float range,
+	CreepHandle * result, size_t maxCount) const
+{
+	size_t count = 0;
+	if (maxCount == 0)
+		return count;
+
+	forEachCreepInRange(center, range, [&](uint32_t index, float) {
+		result[count++] = creeps_.handleAt(index);
+		return count < maxCount;
+	});
+	return count;
+}
+
+size_t CreepGridQueryService::getClosestCreeps(
+	sf::Vector2f center, float range,
+	CreepHandle * result, size_t maxCount) const
+{
+	auto & candidates = getCandidates();
+	forEachCreepInRange(center, range, [&](uint32_t index, float sqDistance) {
+		offerCandidate(candidates, { sqDistance, index }, maxCount);
+		return true;
+	});
+	return writeCandidates(candidates, result);
+}
+
+size_t CreepGridQueryService::getFurthestAlongPathCreeps(
+	sf::Vector2f center, float range,
+	CreepHandle * result, size_t maxCount) const
+{
+	auto & candidates = getCandidates();
+	forEachCreepInRange(center, range, [&](uint32_t index, float) {
+		offerCandidate(candidates, { creeps_.getDistanceToGoal(index, navigation_), index }, maxCount);
+		return true;
+	});
+	return writeCandidates(candidates, result);
+}
@@ -3,22 +3,76 @@
 #ifndef TDF_CREEP_QUERY_SERVICE_HPP
 #define TDF_CREEP_QUERY_SERVICE_HPP
 
-#include <memory>
+#include <cstdint>
 #include <vector>
 #include <limits>
-#include "Creep.hpp"
+#include "CreepStore.hpp"
+#include "../LevelServices.hpp"
 
 //! \class CreepQueryService
-//! \brief Provides Towers with information about closest Creeps.
+//! \brief Provides Towers with information about Creeps around them.
+//! Batched queries write into a buffer given by the caller and return how
+//! many Creeps were written. A Creep is in range when its distance from
+//! the center is smaller than the range. Queries do not change the service,
+//! so they may run from several threads at once.
 class CreepQueryService
 {
+protected:
+	const CreepStore & creeps_;
+	const NavigationProvider<sf::Vector2i> & navigation_;
+
+	struct candidate_t
+	{
+		float key;
+		uint32_t index;
+
+		inline bool operator<(const candidate_t & other) const
+		{
+			return key < other.key || (key == other.key && index < other.index);
+		}
+	};
+
+	//! \brief Returns the scratch buffer of ranked queries, emptied.
+	//! Every thread has its own, so that queries may run in parallel.
+	static std::vector<candidate_t> & getCandidates();
+
+	//! Keeps candidates sorted and at most maxCount long.
+	static void offerCandidate(std::vector<candidate_t> & candidates, candidate_t candidate, size_t maxCount);
+
+	//! Copies Creeps chosen by a ranked query into the result.
+	size_t writeCandidates(const std::vector<candidate_t> & candidates, CreepHandle * result) const;
+
 public:
+	CreepQueryService(
+		const CreepStore & creeps,
+		const NavigationProvider<sf::Vector2i> & navigation);
 	virtual ~CreepQueryService() {}
 
+	inline const CreepStore & getCreeps() const
+	{
+		return creeps_;
+	}
+
 	//! Returns the closest Creep to the given position, in given range.
-	virtual std::shared_ptr<Creep> getClosestCreep(
+	virtual CreepHandle getClosestCreep(
 		sf::Vector2f center,
-		float maxRange = std::numeric_limits<float>::infinity()) = 0;
+		float maxRange = std::numeric_limits<float>::infinity()) const = 0;
+
+	//! Writes up to maxCount Creeps in range, in no particular order.
+	virtual size_t getCreepsInRange(
+		sf::Vector2f center, float range,
+		CreepHandle * result, size_t maxCount) const = 0;
+
+	//! Writes up to maxCount Creeps in range, the closest first.
+	virtual size_t getClosestCreeps(
+		sf::Vector2f center, float range,
+		CreepHandle * result, size_t maxCount) const = 0;
+
+	//! Writes up to maxCount Creeps in range, the one closest
+	//! to reaching the goal first.
+	virtual size_t getFurthestAlongPathCreeps(
+		sf::Vector2f center, float range,
+		CreepHandle * result, size_t maxCount) const = 0;
 };
 
 //! \class CreepVectorQueryService
@@ -26,13 +80,73 @@ public:
 class CreepVectorQueryService final : public CreepQueryService
 {
 private:
-	const std::vector<std::shared_ptr<Creep>> & creeps_;
+	template<typename F>
+	void forEachCreepInRange(sf::Vector2f center, float range, F f) const;
+
+public:
+	CreepVectorQueryService(
+		const CreepStore & creeps,
+		const NavigationProvider<sf::Vector2i> & navigation);
+	virtual CreepHandle getClosestCreep(
+		sf::Vector2f center,
+		float maxRange = std::numeric_limits<float>::infinity()) const override;
+	virtual size_t getCreepsInRange(
+		sf::Vector2f center, float range,
+		CreepHandle * result, size_t maxCount) const override;
+	virtual size_t getClosestCreeps(
+		sf::Vector2f center, float range,
+		CreepHandle * result, size_t maxCount) const override;
+	virtual size_t getFurthestAlongPathCreeps(
+		sf::Vector2f center, float range,
+		CreepHandle * result, size_t maxCount) const override;
+};
+
+//! \class CreepGridQueryService
+//! \brief Buckets Creeps by the level grid cell they are in, so that a query
+//! only checks cells overlapping its range.
+//! The buckets are rebuilt with rebuild() once per tick, reusing memory.
+//! Results are the same as CreepVectorQueryService's, including ties.
+class CreepGridQueryService final : public CreepQueryService
+{
+private:
+	struct entry_t
+	{
+		sf::Vector2f position;
+		uint32_t index;
+	};
+
+	int32_t width_, height_;
+	//! Entries of cell i are entries_[cellStart_[i]] .. entries_[cellStart_[i + 1] - 1]
+	std::vector<uint32_t> cellStart_;
+	std::vector<entry_t> entries_;
+	std::vector<int32_t> creepCells_;
+
+	int32_t cellIndexOf(sf::Vector2f position) const;
+
+	template<typename F>
+	void forEachCreepInRange(sf::Vector2f center, float range, F f) const;
 
 public:
-	CreepVectorQueryService(const std::vector<std::shared_ptr<Creep>> & creeps);
-	virtual std::shared_ptr<Creep> getClosestCreep(
+	CreepGridQueryService(
+		const CreepStore & creeps,
+		const NavigationProvider<sf::Vector2i> & navigation,
+		int32_t width, int32_t height);
+
+	//! Rebuilds buckets from current positions of the Creeps.
+	void rebuild();
+
+	virtual CreepHandle getClosestCreep(
 		sf::Vector2f center,
-		float maxRange = std::numeric_limits<float>::infinity()) override;
+		float maxRange = std::numeric_limits<float>::infinity()) const override;
+	virtual size_t getCreepsInRange(
+		sf::Vector2f center, float range,
+		CreepHandle * result, size_t maxCount) const override;
+	virtual size_t getClosestCreeps(
+		sf::Vector2f center, float range,
+		CreepHandle * result, size_t maxCount) const override;
+	virtual size_t getFurthestAlongPathCreeps(
+		sf::Vector2f center, float range,
+		CreepHandle * result, size_t maxCount) const override;
 };
 
 #endif // TDF_CREEP_QUERY_SERVICE_HPP
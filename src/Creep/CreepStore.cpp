@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "CreepStore.hpp"
+#include "../LevelServices.hpp"
+
+CreepHandle CreepStore::add(
+	const std::string & typeName,
+	int32_t maxLife, int32_t bounty,
+	sf::Vector2i position)
+{
+	const auto type = std::find(typeNames_.begin(), typeNames_.end(), typeName);
+	typeIds_.push_back((uint32_t)(type - typeNames_.begin()));
+	if (type == typeNames_.end())
+		typeNames_.push_back(typeName);
+
+	const CreepHandle handle = handles_.add();
+
+	from_.push_back(position);
+	to_.push_back(position);
+	progress_.push_back(1.f);
+	positions_.push_back({ (float)position.x, (float)position.y });
+
+	life_.push_back(maxLife);
+	maxLife_.push_back(maxLife);
+	bounty_.push_back(bounty);
+
+	speedBuffs_.push_back(0.f);
+	vulnerabilityBuffs_.push_back(0.f);
+
+	return handle;
+}
+
+void CreepStore::recalculateBuffs()
+{
+	std::fill(speedBuffs_.begin(), speedBuffs_.end(), 0.f);
+	std::fill(vulnerabilityBuffs_.begin(), vulnerabilityBuffs_.end(), 0.f);
+
+	for (const auto & b : buffs_) {
+		const uint32_t index = handles_.indexOf(b.owner);
+		if (b.buff.type == CreepBuff::Type::BUFF_SPEED)
+			speedBuffs_[index] += b.buff.strength;
+		else
+			vulnerabilityBuffs_[index] += b.buff.strength;
+	}
+}
+
+void CreepStore::updateBuffs(sf::Time dt)
+{
+	// Drop expired buffs and buffs of Creeps which left the level
+	const double elapsed = dt.asMicroseconds() * 1e-6;
+	for (auto & b : buffs_)
+		b.buff.duration -= elapsed;
+
+	buffs_.erase(std::remove_if(buffs_.begin(), buffs_.end(), [&](const buff_t & b) {
+		return b.buff.duration <= 0.0 || !handles_.contains(b.owner);
+	}), buffs_.end());
+
+	recalculateBuffs();
+}
+
+bool CreepStore::walk(sf::Time dt, const NavigationProvider<sf::Vector2i> & navigation, uint32_t begin, uint32_t end)
+{
+	const float seconds = dt.asSeconds();
+	bool stepped = false;
+	for (uint32_t i = begin; i < end; ++i) {
+		const float speedBuff = std::max(speedBuffs_[i], -59.f);
+		sf::Vector2i & p0 = from_[i];
+		sf::Vector2i & p1 = to_[i];
+		float & progress = progress_[i];
+
+		progress += seconds + speedBuff * seconds / 60.0f;
+		while (progress > 1.f) {
+			p0 = p1;
+			p1 = navigation.getNextStep(p1);
+			progress -= 1.f;
+			stepped = true;
+		}
+
+		const sf::Vector2f v0 = { (float)p0.x, (float)p0.y };
+		const sf::Vector2f v1 = { (float)p1.x, (float)p1.y };
+		positions_[i] = (1.f - progress) * v0 + progress * v1;
+	}
+
+	return stepped;
+}
+
+void CreepStore::applyBuff(uint32_t index, CreepBuff buff)
+{
+	buffs_.push_back({ handles_.handleAt(index), buff });
+	if (buff.type == CreepBuff::Type::BUFF_SPEED)
+		speedBuffs_[index] += buff.strength;
+	else
+		vulnerabilityBuffs_[index] += buff.strength;
+}
+
+void CreepStore::inflictDamage(uint32_t index, int32_t damage)
+{
+	const float vuln = vulnerabilityBuffs_[index] / 100.f + 1.f;
+	life_[index] = std::max(0, life_[index] - int(round(damage * vuln)));
+}
+
+float CreepStore::getDistanceToGoal(uint32_t index, const NavigationProvider<sf::Vector2i> & navigation) const
+{
+	const float remaining = (from_[index] == to_[index]) ? 0.f : 1.f - progress_[index];
+	return (float)navigation.getDistanceToGoal(to_[index]) + remaining;
+}
+
+void CreepStore::save(BinaryWriter & writer) const
+{
+	handles_.save(writer);
+
+	writer.writeUnsigned(typeNames_.size());
+	for (const auto & name : typeNames_)
+		writer.writeString(name);
+
+	for (uint32_t i = 0; i < size(); ++i) {
+		writer.writeUnsigned(typeIds_[i]);
+		writer.writeVector(from_[i]);
+		writer.writeVector(to_[i]);
+		writer.writeFloat(progress_[i]);
+		writer.writeVector(positions_[i]);
+		writer.writeSigned(life_[i]);
+		writer.writeSigned(maxLife_[i]);
+		writer.writeSigned(bounty_[i]);
+		writer.writeFloat(speedBuffs_[i]);
+		writer.writeFloat(vulnerabilityBuffs_[i]);
+	}
+
+	writer.writeUnsigned(buffs_.size());
+	for (const auto & b : buffs_) {
+		b.owner.save(writer);
+		writer.writeDouble(b.buff.duration);
+		writer.writeByte((uint8_t)b.buff.type);
+		writer.writeFloat(b.buff.strength);
+	}
+}
+
+CreepHandle CreepStore::loadHandle(BinaryReader & reader) const
+{
+	const CreepHandle handle = CreepHandle::load(reader);
+	if (!handles_.wasIssued(handle))
+		throw std::runtime_error("Saved data refers to an unknown Creep");
+	return handle;
+}
+
+void CreepStore::load(BinaryReader & reader)
+{
+	handles_.load(reader);
+
+	typeNames_.resize(reader.readCount());
+	for (auto & name : typeNames_)
+		name = reader.readString();
+
+	const uint32_t count = (uint32_t)size();
+	typeIds_.resize(count);
+	from_.resize(count);
+	to_.resize(count);
+	progress_.resize(count);
+	positions_.resize(count);
+	life_.resize(count);
+	maxLife_.resize(count);
+	bounty_.resize(count);
+	speedBuffs_.resize(count);
+	vulnerabilityBuffs_.resize(count);
+
+	for (uint32_t i = 0; i < count; ++i) {
+		typeIds_[i] = (uint32_t)reader.readUnsigned();
+		if (typeIds_[i] >= typeNames_.size())
+			throw std::runtime_error("Saved Creep has an unknown type");
+		from_[i] = reader.readVector2i();
+		to_[i] = reader.readVector2i();
+		progress_[i] = reader.readFloat();
+		if (!(progress_[i] >= 0.f && progress_[i] <= 1.f))
+			throw std::runtime_error("Saved Creep has an invalid walk progress");
+		positions_[i] = reader.readVector2f();
+		life_[i] = (int32_t)reader.readSigned();
+		maxLife_[i] = (int32_t)reader.readSigned();
+		bounty_[i] = (int32_t)reader.readSigned();
+		speedBuffs_[i] = reader.readFloat();
+		vulnerabilityBuffs_[i] = reader.readFloat();
+	}
+
+	buffs_.clear();
+	const size_t buffCount = reader.readCount();
+	for (size_t i = 0; i < buffCount; ++i) {
+		const CreepHandle owner = loadHandle(reader);
+		const double duration = reader.readDouble();
+		const uint8_t type = reader.readByte();
+		if (type > (uint8_t)CreepBuff::Type::BUFF_VULNERABILITY)
+			throw std::runtime_error("Saved buff has an unknown type");
+		const float strength = reader.readFloat();
+		buffs_.push_back({ owner, CreepBuff(duration, (CreepBuff::Type)type, strength) });
+	}
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+#ifndef TDF_CREEP_STORE_HPP
+#define TDF_CREEP_STORE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <SFML/System.hpp>
+
+#include "../EntityRegistry.hpp"
+#include "Buff.hpp"
+
+template<typename P> class NavigationProvider;
+
+//! Creeps have no class of their own, their state lives in a CreepStore.
+class Creep;
+typedef Handle<Creep> CreepHandle;
+
+//! \brief Keeps all Creeps of a level in contiguous arrays, one per attribute.
+//! Creeps are addressed either by a CreepHandle, or by their index in the
+//! arrays, which is only valid until the next removal. Indices follow the
+//! order in which Creeps were added.
+class CreepStore
+{
+private:
+	struct buff_t
+	{
+		CreepHandle owner;
+		CreepBuff buff;
+	};
+
+	HandleTable<Creep> handles_;
+
+	std::vector<uint32_t> typeIds_;
+	std::vector<std::string> typeNames_;
+
+	//! A Creep has walked progress_ of the way from from_ to to_.
+	std::vector<sf::Vector2i> from_, to_;
+	std::vector<float> progress_;
+	std::vector<sf::Vector2f> positions_;
+
+	std::vector<int32_t> life_, maxLife_;
+	std::vector<int32_t> bounty_;
+
+	//! Sums of strengths of active buffs, per Creep.
+	std::vector<float> speedBuffs_, vulnerabilityBuffs_;
+	//! Active buffs of all Creeps, in order of application.
+	std::vector<buff_t> buffs_;
+
+	void recalculateBuffs();
+
+public:
+	//! Adds a Creep standing at the given point of the grid.
+	CreepHandle add(
+		const std::string & typeName,
+		int32_t maxLife, int32_t bounty,
+		sf::Vector2i position);
+
+	//! \brief Removes all Creeps for which f(index) returns true.
+	//! Remaining Creeps keep their relative order.
+	template<typename F>
+	void removeIf(F f);
+
+	inline size_t size() const
+	{
+		return handles_.size();
+	}
+
+	inline bool empty() const
+	{
+		return handles_.size() == 0;
+	}
+
+	inline bool contains(CreepHandle handle) const
+	{
+		return handles_.contains(handle);
+	}
+
+	//! Returns the index of a Creep which is in the store.
+	inline uint32_t indexOf(CreepHandle handle) const
+	{
+		return handles_.indexOf(handle);
+	}
+
+	inline CreepHandle handleAt(uint32_t index) const
+	{
+		return handles_.handleAt(index);
+	}
+
+	//! \brief Reads a handle saved along with another entity.
+	//! Throws std::runtime_error unless the store could have issued it.
+	CreepHandle loadHandle(BinaryReader & reader) const;
+
+	void save(BinaryWriter & writer) const;
+
+	//! \brief Replaces all Creeps with saved ones.
+	//! Throws std::runtime_error if the saved data is malformed.
+	void load(BinaryReader & reader);
+
+	//! Advances buffs of all Creeps, dropping expired ones.
+	void updateBuffs(sf::Time dt);
+
+	//! \brief Makes Creeps from begin to end walk, after their buffs were updated.
+	//! Each Creep only changes itself, so ranges may walk in parallel.
+	//! Returns if any of them stepped on to the next field of its path.
+	bool walk(sf::Time dt, const NavigationProvider<sf::Vector2i> & navigation, uint32_t begin, uint32_t end);
+
+	void applyBuff(uint32_t index, CreepBuff buff);
+	void inflictDamage(uint32_t index, int32_t damage);
+
+	inline const std::vector<sf::Vector2f> & getPositions() const
+	{
+		return positions_;
+	}
+
+	inline sf::Vector2f getPosition(uint32_t index) const
+	{
+		return positions_[index];
+	}
+
+	inline sf::Vector2f getFacingDirection(uint32_t index) const
+	{
+		return sf::Vector2f(to_[index] - from_[index]);
+	}
+
+	inline const std::string & getTypeName(uint32_t index) const
+	{
+		return typeNames_[typeIds_[index]];
+	}
+
+	//! Returns how far the Creep still has to walk to reach the goal.
+	float getDistanceToGoal(uint32_t index, const NavigationProvider<sf::Vector2i> & navigation) const;
+
+	//! Returns the grid points between which the Creep walks;
+	//! Towers can not be placed on them.
+	inline sf::Vector2i getWalkFrom(uint32_t index) const
+	{
+		return from_[index];
+	}
+
+	inline sf::Vector2i getWalkTo(uint32_t index) const
+	{
+		return to_[index];
+	}
+
+	inline bool isAlive(uint32_t index) const
+	{
+		return life_[index] > 0;
+	}
+
+	inline bool hasReachedGoal(uint32_t index) const
+	{
+		return from_[index] == to_[index];
+	}
+
+	inline int32_t getLife(uint32_t index) const
+	{
+		return life_[index];
+	}
+
+	inline int32_t getMaxLife(uint32_t index) const
+	{
+		return maxLife_[index];
+	}
+
+	inline int32_t getBounty(uint32_t index) const
+	{
+		return bounty_[index];
+	}
+
+	inline float getBuffStrength(uint32_t index, CreepBuff::Type type) const
+	{
+		return (type == CreepBuff::Type::BUFF_SPEED) ? speedBuffs_[index] : vulnerabilityBuffs_[index];
+	}
+};
+
+template<typename F>
+void CreepStore::removeIf(F f)
+{
+	const uint32_t kept = handles_.removeIf(f, [&](uint32_t from, uint32_t to) {
+		typeIds_[to] = typeIds_[from];
+		from_[to] = from_[from];
+		to_[to] = to_[from];
+		progress_[to] = progress_[from];
+		positions_[to] = positions_[from];
+		life_[to] = life_[from];
+		maxLife_[to] = maxLife_[from];
+		bounty_[to] = bounty_[from];
+		speedBuffs_[to] = speedBuffs_[from];
+		vulnerabilityBuffs_[to] = vulnerabilityBuffs_[from];
+	});
+
+	typeIds_.resize(kept);
+	from_.resize(kept);
+	to_.resize(kept);
+	progress_.resize(kept);
+	positions_.resize(kept);
+	life_.resize(kept);
+	maxLife_.resize(kept);
+	bounty_.resize(kept);
+	speedBuffs_.resize(kept);
+	vulnerabilityBuffs_.resize(kept);
+}
+
+#endif // TDF_CREEP_STORE_HPP
@@ -0,0 +1,64 @@
+#include <stdexcept>
+#include <SFGUI/Widgets.hpp>
+#include "../MakeUnique.hpp"
+#include "../Game.hpp"
+#include "CreepLifeDisplayComponent.hpp"
+#include "CreepView.hpp"
+
+CreepView::CreepView(const CreepStore & creeps, CreepHandle creep, Game & game)
+	: creeps_(creeps)
+	, creep_(creep)
+	, previousPosition_(creeps.getPosition(creeps.indexOf(creep)))
+	, position_(previousPosition_)
+{
+	const auto & typeName = creeps.getTypeName(creeps.indexOf(creep));
+	if (typeName == "GenericCreep") {
+		auto dotDisplay = std::make_unique<CreepDotDisplayComponent>(creeps, creep, 0.125f,
+			game.getTexture("Creep"), game.getAnimation("Creep"));
+
+		auto lifeDisplay = std::make_unique<CreepLifeDisplayComponent>(
+			sf::Vector2f(0.f, 0.5f), sf::Vector2f(0.8f, 0.2f), true);
+		lifeDisplay->setOwner(creeps, creep);
+
+		auto compositeDisplay = std::make_unique<CreepCompositeDisplayComponent>();
+		compositeDisplay->addChild(std::move(dotDisplay));
+		compositeDisplay->addChild(std::move(lifeDisplay));
+
+		displayComponent_ = std::move(compositeDisplay);
+		return;
+	}
+
+	throw std::runtime_error("Unknown Creep type: " + typeName);
+}
+
+void CreepView::update(const sf::Time & dt)
+{
+	previousPosition_ = position_;
+	position_ = creeps_.getPosition(creeps_.indexOf(creep_));
+	displayComponent_->update(dt);
+}
+
+void CreepView::render(SpriteBatch & batch)
+{
+	displayComponent_->render(batch);
+}
+
+void CreepView::render(SpriteBatch & batch, float interpolation)
+{
+	// Display components draw the Creep where it is now, move it back
+	sf::Transform transform;
+	transform.translate(getPosition(interpolation) - position_);
+	batch.setTransform(transform);
+	displayComponent_->render(batch);
+	batch.setTransform(sf::Transform::Identity);
+}
+
+bool CreepView::isHit(sf::Vector2f point) const
+{
+	return displayComponent_->isHit(point);
+}
+
+sfg::Widget::Ptr CreepView::getPanel(std::shared_ptr<LevelInstance> /*levelInstance*/)
+{
+	return sfg::Label::Create("Creep #" + std::to_string(creep_.slot));
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#ifndef TDF_CREEP_VIEW_HPP
+#define TDF_CREEP_VIEW_HPP
+
+#include <memory>
+#include <SFML/Graphics.hpp>
+
+#include "../Selectable.hpp"
+#include "../Renderable.hpp"
+#include "CreepDisplayComponent.hpp"
+#include "CreepStore.hpp"
+
+class Game;
+
+//! \brief The visual side of a Creep.
+//! It lives only as long as the Creep stays in the level, and is
+//! what the player actually selects by clicking on a Creep.
+class CreepView final : public Selectable, public Renderable
+{
+private:
+	const CreepStore & creeps_;
+	CreepHandle creep_;
+	//! Positions after the last two ticks, to draw the Creep in between.
+	sf::Vector2f previousPosition_, position_;
+	std::unique_ptr<CreepDisplayComponent> displayComponent_;
+
+public:
+	CreepView(const CreepStore & creeps, CreepHandle creep, Game & game);
+
+	//! Returns if the Creep has left the level.
+	inline bool isExpired() const
+	{
+		return !creeps_.contains(creep_);
+	}
+
+	//! Returns where the Creep is drawn, given a fraction of a tick.
+	inline sf::Vector2f getPosition(float interpolation) const
+	{
+		return previousPosition_ + (position_ - previousPosition_) * interpolation;
+	}
+
+	virtual void update(const sf::Time & dt) override;
+	virtual void render(SpriteBatch & batch) override;
+	void render(SpriteBatch & batch, float interpolation);
+	virtual bool isHit(sf::Vector2f point) const override;
+	virtual sfg::Widget::Ptr getPanel(std::shared_ptr<LevelInstance> levelInstance) override;
+};
+
+#endif // TDF_CREEP_VIEW_HPP
@@ -20,9 +20,9 @@ void CreepSourceDecoration::update(sf::Time dt)
 	rectangleShape_.rotate(dt.asSeconds() * ROTATION_SPEED);
 }
 
-void CreepSourceDecoration::render(sf::RenderTarget & target)
+void CreepSourceDecoration::render(SpriteBatch & batch)
 {
-	target.draw(rectangleShape_);
+	batch.add(rectangleShape_);
 }
 
 GoalDecoration::GoalDecoration(sf::Vector2f position)
@@ -39,12 +39,12 @@ void GoalDecoration::update(sf::Time dt)
 		phase_ -= 2.f * M_PI;
 }
 
-void GoalDecoration::render(sf::RenderTarget & target)
+void GoalDecoration::render(SpriteBatch & batch)
 {
 	const float radius = 
 		(MAX_RADIUS + MIN_RADIUS) * 0.5f
 		+ sin(phase_) * (MAX_RADIUS - MIN_RADIUS) * 0.5f;
 	circleShape_.setRadius(radius);
 	circleShape_.setOrigin({ radius, radius });
-	target.draw(circleShape_);
+	batch.add(circleShape_);
 }
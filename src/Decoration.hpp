@@ -21,7 +21,7 @@ class CreepSourceDecoration : public Decoration
 public:
 	CreepSourceDecoration(sf::Vector2f position);
 	virtual void update(sf::Time dt) override;
-	virtual void render(sf::RenderTarget & target) override;
+	virtual void render(SpriteBatch & batch) override;
 };
 
 class GoalDecoration : public Decoration
@@ -32,7 +32,7 @@ class GoalDecoration : public Decoration
 public:
 	GoalDecoration(sf::Vector2f position);
 	virtual void update(sf::Time dt) override;
-	virtual void render(sf::RenderTarget & target) override;
+	virtual void render(SpriteBatch & batch) override;
 };
 
 #endif // TDF_DECORATION_HPP
@@ -0,0 +1,364 @@
+#pragma once
+
+#ifndef TDF_ENTITY_REGISTRY_HPP
+#define TDF_ENTITY_REGISTRY_HPP
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "BinaryStream.hpp"
+
+//! \brief Generational reference to an entity of type T.
+//! When an entity is removed its slot gets a new generation, so handles
+//! to it stop resolving, even after the slot is reused.
+template<typename T>
+struct Handle
+{
+	static const uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+	uint32_t slot;
+	uint32_t generation;
+
+	Handle() : slot(NONE), generation(0) {}
+	Handle(uint32_t slot, uint32_t generation) : slot(slot), generation(generation) {}
+
+	explicit operator bool() const
+	{
+		return slot != NONE;
+	}
+
+	bool operator==(const Handle & other) const
+	{
+		return slot == other.slot && generation == other.generation;
+	}
+
+	bool operator!=(const Handle & other) const
+	{
+		return !(*this == other);
+	}
+
+	void save(BinaryWriter & writer) const
+	{
+		writer.writeUnsigned(slot);
+		writer.writeUnsigned(generation);
+	}
+
+	static Handle load(BinaryReader & reader)
+	{
+		const uint32_t slot = (uint32_t)reader.readUnsigned();
+		const uint32_t generation = (uint32_t)reader.readUnsigned();
+		return Handle(slot, generation);
+	}
+};
+
+//! \brief Maps handles to indices of entities stored contiguously by
+//! their owner, at indices from 0 to size() - 1.
+//! The owner reports every addition and removal, so that resolving
+//! a handle is one array access and one generation compare.
+template<typename T>
+class HandleTable
+{
+private:
+	struct slot_t
+	{
+		uint32_t index;
+		uint32_t generation;
+	};
+
+	std::vector<slot_t> slots_;
+	//! Slot of the entity at given index.
+	std::vector<uint32_t> slotOf_;
+	std::vector<uint32_t> freeSlots_;
+	uint64_t allocations_;
+
+public:
+	HandleTable() : allocations_(0) {}
+
+	//! Returns a handle for a new entity stored at index size().
+	Handle<T> add()
+	{
+		uint32_t slot;
+		if (freeSlots_.empty()) {
+			slot = (uint32_t)slots_.size();
+			allocations_ += slots_.size() == slots_.capacity();
+			slots_.push_back({ 0, 0 });
+		}
+		else {
+			slot = freeSlots_.back();
+			freeSlots_.pop_back();
+		}
+
+		slots_[slot].index = (uint32_t)slotOf_.size();
+		allocations_ += slotOf_.size() == slotOf_.capacity();
+		slotOf_.push_back(slot);
+		return Handle<T>(slot, slots_[slot].generation);
+	}
+
+	//! \brief Removes entities for which remove(index) returns true.
+	//! The rest keep their relative order; move(from, to) is called for each
+	//! of them which has to move to a lower index. Returns the new size.
+	template<typename F, typename M>
+	uint32_t removeIf(F remove, M move)
+	{
+		const uint32_t count = (uint32_t)slotOf_.size();
+		uint32_t kept = 0;
+
+		for (uint32_t i = 0; i < count; ++i) {
+			const uint32_t slot = slotOf_[i];
+			if (remove(i)) {
+				++slots_[slot].generation;
+				slots_[slot].index = Handle<T>::NONE;
+				allocations_ += freeSlots_.size() == freeSlots_.capacity();
+				freeSlots_.push_back(slot);
+				continue;
+			}
+
+			if (kept != i) {
+				move(i, kept);
+				slotOf_[kept] = slot;
+				slots_[slot].index = kept;
+			}
+			++kept;
+		}
+
+		slotOf_.resize(kept);
+		return kept;
+	}
+
+	inline size_t size() const
+	{
+		return slotOf_.size();
+	}
+
+	//! Returns how many times the table had to grow its storage.
+	inline uint64_t getAllocationCount() const
+	{
+		return allocations_;
+	}
+
+	//! A free slot is always a generation ahead of handles issued for it,
+	//! so a matching generation means the entity is still there.
+	inline bool contains(Handle<T> handle) const
+	{
+		return handle.slot < slots_.size()
+			&& slots_[handle.slot].generation == handle.generation;
+	}
+
+	//! Returns the index of an entity which is in the table.
+	inline uint32_t indexOf(Handle<T> handle) const
+	{
+		return slots_[handle.slot].index;
+	}
+
+	inline Handle<T> handleAt(uint32_t index) const
+	{
+		const uint32_t slot = slotOf_[index];
+		return Handle<T>(slot, slots_[slot].generation);
+	}
+
+	//! \brief Tells if the table could have issued the handle: it is null,
+	//! refers to an entity in the table, or to one removed from it.
+	//! Handles read from saved data have to pass before they are used.
+	inline bool wasIssued(Handle<T> handle) const
+	{
+		if (!handle)
+			return true;
+		if (handle.slot >= slots_.size())
+			return false;
+
+		const slot_t & slot = slots_[handle.slot];
+		return handle.generation < slot.generation
+			|| (handle.generation == slot.generation && slot.index < slotOf_.size());
+	}
+
+	//! Saves the slots, so that handles keep resolving after a load.
+	void save(BinaryWriter & writer) const
+	{
+		writer.writeUnsigned(slots_.size());
+		for (const auto & slot : slots_) {
+			writer.writeUnsigned(slot.index);
+			writer.writeUnsigned(slot.generation);
+		}
+
+		writer.writeUnsigned(slotOf_.size());
+		for (uint32_t slot : slotOf_)
+			writer.writeUnsigned(slot);
+
+		writer.writeUnsigned(freeSlots_.size());
+		for (uint32_t slot : freeSlots_)
+			writer.writeUnsigned(slot);
+	}
+
+	//! \brief Replaces the contents of the table with saved ones.
+	//! Every slot has to be either used or free, but not both.
+	//! Throws std::runtime_error if they do not fit together.
+	void load(BinaryReader & reader)
+	{
+		slots_.resize(reader.readCount());
+		for (auto & slot : slots_) {
+			slot.index = (uint32_t)reader.readUnsigned();
+			slot.generation = (uint32_t)reader.readUnsigned();
+		}
+
+		// Indices of used slots are unique, so no slot is used twice
+		std::vector<bool> seen(slots_.size(), false);
+		slotOf_.resize(reader.readCount());
+		for (uint32_t i = 0; i < slotOf_.size(); ++i) {
+			slotOf_[i] = (uint32_t)reader.readUnsigned();
+			if (slotOf_[i] >= slots_.size() || slots_[slotOf_[i]].index != i)
+				throw std::runtime_error("Saved handles are inconsistent");
+			seen[slotOf_[i]] = true;
+		}
+
+		// Free slots point nowhere, as they do after removeIf
+		freeSlots_.resize(reader.readCount());
+		for (auto & slot : freeSlots_) {
+			slot = (uint32_t)reader.readUnsigned();
+			if (slot >= slots_.size() || seen[slot])
+				throw std::runtime_error("Saved handles are inconsistent");
+			seen[slot] = true;
+			slots_[slot].index = Handle<T>::NONE;
+		}
+
+		if (slotOf_.size() + freeSlots_.size() != slots_.size())
+			throw std::runtime_error("Saved handles are inconsistent");
+	}
+};
+
+//! \brief Owns entities of type T, stored contiguously in order of addition
+//! and referenced from the outside by generational handles.
+//! Storage of removed entities is reused, so a registry whose population
+//! stopped growing does not allocate; the counters below confirm it.
+template<typename T>
+class EntityRegistry
+{
+private:
+	HandleTable<T> handles_;
+	std::vector<T> entities_;
+	uint64_t added_;
+	uint64_t allocations_;
+
+public:
+	typedef typename std::vector<T>::iterator iterator;
+	typedef typename std::vector<T>::const_iterator const_iterator;
+
+	EntityRegistry() : added_(0), allocations_(0) {}
+
+	Handle<T> add(T && entity)
+	{
+		++added_;
+		allocations_ += entities_.size() == entities_.capacity();
+		entities_.push_back(std::move(entity));
+		return handles_.add();
+	}
+
+	//! \brief Removes entities for which f(entity) returns true.
+	//! The rest keep their relative order.
+	template<typename F>
+	void removeIf(F f)
+	{
+		const uint32_t kept = handles_.removeIf(
+			[&](uint32_t index) { return f(entities_[index]); },
+			[&](uint32_t from, uint32_t to) { entities_[to] = std::move(entities_[from]); });
+		entities_.erase(entities_.begin() + kept, entities_.end());
+	}
+
+	//! Removes the entity if it is still in the registry.
+	void remove(Handle<T> handle)
+	{
+		if (!contains(handle))
+			return;
+
+		const uint32_t removed = handles_.indexOf(handle);
+		const uint32_t kept = handles_.removeIf(
+			[&](uint32_t index) { return index == removed; },
+			[&](uint32_t from, uint32_t to) { entities_[to] = std::move(entities_[from]); });
+		entities_.erase(entities_.begin() + kept, entities_.end());
+	}
+
+	inline bool contains(Handle<T> handle) const
+	{
+		return handles_.contains(handle);
+	}
+
+	//! Returns the entity, or null if the handle no longer resolves.
+	inline T * find(Handle<T> handle)
+	{
+		return contains(handle) ? &entities_[handles_.indexOf(handle)] : nullptr;
+	}
+
+	inline const T * find(Handle<T> handle) const
+	{
+		return contains(handle) ? &entities_[handles_.indexOf(handle)] : nullptr;
+	}
+
+	inline Handle<T> handleAt(uint32_t index) const
+	{
+		return handles_.handleAt(index);
+	}
+
+	inline T & operator[](uint32_t index)
+	{
+		return entities_[index];
+	}
+
+	inline const T & operator[](uint32_t index) const
+	{
+		return entities_[index];
+	}
+
+	inline size_t size() const
+	{
+		return entities_.size();
+	}
+
+	inline bool empty() const
+	{
+		return entities_.empty();
+	}
+
+	//! Returns how many entities were added since the registry was created.
+	inline uint64_t getAddedCount() const
+	{
+		return added_;
+	}
+
+	//! Returns how many times the registry had to grow its storage.
+	inline uint64_t getAllocationCount() const
+	{
+		return allocations_ + handles_.getAllocationCount();
+	}
+
+	//! Saves the registry, calling save(writer) of every entity.
+	void save(BinaryWriter & writer) const
+	{
+		writer.writeUnsigned(added_);
+		handles_.save(writer);
+		for (const auto & entity : entities_)
+			entity.save(writer);
+	}
+
+	//! \brief Replaces the contents of the registry with saved ones.
+	//! loadEntity(reader) has to read and return a single entity.
+	template<typename F>
+	void load(BinaryReader & reader, F loadEntity)
+	{
+		added_ = reader.readUnsigned();
+		handles_.load(reader);
+
+		entities_.clear();
+		allocations_ += handles_.size() > entities_.capacity();
+		entities_.reserve(handles_.size());
+		for (size_t i = 0; i < handles_.size(); ++i)
+			entities_.push_back(loadEntity(reader));
+	}
+
+	inline iterator begin() { return entities_.begin(); }
+	inline iterator end() { return entities_.end(); }
+	inline const_iterator begin() const { return entities_.begin(); }
+	inline const_iterator end() const { return entities_.end(); }
+};
+
+#endif // TDF_ENTITY_REGISTRY_HPP
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <exception>
 #include <fstream>
 #include <iostream>
@@ -18,9 +19,8 @@
 #endif
 
 Game::Game(int /*argc*/, char ** /*argv*/)
+	: jobs_(JobSystem::getDefaultWorkerCount())
 {
-	srand((unsigned int)time(nullptr));
-
 	sfg::Renderer::Set(sfg::VertexArrayRenderer::Create());
 
 	const sf::Uint32 style = sf::Style::Titlebar | sf::Style::Close | sf::Style::Resize;
@@ -29,7 +29,8 @@ Game::Game(int /*argc*/, char ** /*argv*/)
 		throw std::runtime_error("Failed to create window");
 
 	window_.resetGLStates();
-	window_.setFramerateLimit(60);
+	// Frames follow the display, ticks stay fixed and are interpolated between
+	window_.setVerticalSyncEnabled(true);
 	window_.setActive();
 
 	loadResources();
@@ -115,12 +116,19 @@ void Game::setNextState(std::unique_ptr<GameState> gameState)
 
 int Game::run()
 {
+	const sf::Time tick = sf::seconds(Constants::SECONDS_PER_FRAME);
+	sf::Clock clock;
+	sf::Time lag;
+
 	while (window_.isOpen()) {
-		if (nextState_)
+		// A new state starts without the time owed to the old one
+		if (nextState_) {
 			currentState_ = std::move(nextState_);
+			lag = sf::Time::Zero;
+		}
 
 		sf::Event evt;
-		if (window_.pollEvent(evt)) {
+		while (window_.pollEvent(evt)) {
 			switch (evt.type) {
 			case sf::Event::Closed:
 				window_.close();
@@ -131,14 +139,20 @@ int Game::run()
 				break;
 			}
 		}
-		else {
-			if (currentState_)
-				currentState_->update(sf::seconds(Constants::SECONDS_PER_FRAME));
+
+		// Run as many fixed ticks as real time has passed, but none
+		// after the state has asked to be replaced
+		lag = std::min(lag + clock.restart(), tick * (float)Constants::MAX_TICKS_PER_FRAME);
+		while (lag >= tick && !nextState_) {
 			if (currentState_)
-				currentState_->render(window_);
-			sfgui_.Display(window_);
-			window_.display();
+				currentState_->update(tick);
+			lag -= tick;
 		}
+
+		if (currentState_)
+			currentState_->render(window_, lag / tick);
+		sfgui_.Display(window_);
+		window_.display();
 	}
 
 	return 0;
@@ -174,6 +188,11 @@ const thor::FrameAnimation& Game::getAnimation(const std::string &id) const
 	return animations_holder_[id];
 }
 
+JobSystem & Game::getJobSystem()
+{
+	return jobs_;
+}
+
 int main(int argc, char ** argv)
 {
 	try {
@@ -15,6 +15,8 @@
 #include <Thor/Resources.hpp>
 #include <Thor/Animations.hpp>
 
+#include "JobSystem.hpp"
+
 class GameState;
 
 class Game
@@ -27,6 +29,7 @@ private:
 	thor::ResourceHolder<thor::FrameAnimation, std::string> animations_holder_;
 
 	std::unique_ptr<GameState> currentState_, nextState_;
+	JobSystem jobs_;
 
 	//! Load all resources into thor::ResourceHolder
 	void loadResources();
@@ -52,6 +55,9 @@ public:
 	const sf::Texture& getTexture(const std::string &id) const;
 	const sf::SoundBuffer& getSound(const std::string &id) const;
 	const thor::FrameAnimation& getAnimation(const std::string &id) const;
+
+	//! Returns the worker threads shared by the game states.
+	JobSystem & getJobSystem();
 };
 
 #endif // TDF_GAME_HPP
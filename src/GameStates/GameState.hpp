@@ -14,7 +14,10 @@ public:
 	virtual ~GameState() {}
 
 	virtual void update(sf::Time /*dt*/) {};
-	virtual void render(sf::RenderTarget & /*target*/) {};
+
+	//! \brief Draws the state. interpolation tells how far, in ticks,
+	//! real time is past the last update, from 0 to 1.
+	virtual void render(sf::RenderTarget & /*target*/, float /*interpolation*/) {};
 	virtual void handleEvent(const sf::Event & /*evt*/) {};
 };
 
@@ -1,7 +1,10 @@
+#include <ctime>
 #include <fstream>
 #include "../MakeUnique.hpp"
+#include "../Constants.hpp"
 #include "../Level.hpp"
-#include "../Creep/Creep.hpp"
+#include "../SavedGame.hpp"
+#include "../Creep/CreepStore.hpp"
 #include "../Tower/Tower.hpp"
 #include "../Tower/TowerFactory.hpp"
 #include "../Game.hpp"
@@ -9,17 +12,38 @@
 #include "MenuGameState.hpp"
 
 static const int RIGHT_PANEL_WIDTH = 200;
+static const int32_t MAX_SPEED = 0;
+//! Time a frame may spend on the simulation when fast-forwarding.
+static const sf::Int32 FRAME_BUDGET_MS = 12;
+static const char * const REPLAY_PATH = "last-level.tdlog";
+
+const char * const LevelGameState::SAVE_PATH = "saved.tdsave";
+const char * const LevelGameState::AUTOSAVE_PATH = "autosave.tdsave";
 
 LevelGameState::LevelGameState(Game & game, std::istream & source)
+	: LevelGameState(game, std::make_shared<LevelInstance>(std::make_shared<Level>(source), (uint64_t)time(nullptr)))
+{
+}
+
+LevelGameState::LevelGameState(Game & game, std::shared_ptr<LevelInstance> levelInstance)
 	: game_(game)
-	, level_(std::make_shared<Level>(source, game))
-	, levelInstance_(new LevelInstance(level_, game))
+	, level_(levelInstance->getLevel())
+	, levelInstance_(levelInstance)
+	, levelRenderer_(new LevelRenderer(*levelInstance_, game))
 	, oldCash_(-1)
 	, oldLives_(-1)
 	, oldWave_(-2)
 	, conguiActive_(false)
+	, debugActive_(false)
 	, isPlacingTower_(false)
+	, speed_(1)
+	, isFrameRendered_(true)
+	, inputLog_(*levelInstance_, Constants::KEYFRAME_INTERVAL)
+	, autosavedWave_(levelInstance_->getInvasionManager().getWaveNumber())
 {
+	levelInstance_->setRecorder(&inputLog_);
+	levelInstance_->setJobSystem(&game.getJobSystem());
+
 	guiCashLabel_ = sfg::Label::Create();
 	guiCashLabel_->SetRequisition({ 0.f, 16.f });
 	guiCashLabel_->SetAlignment({ 0.f, 0.f });
@@ -39,8 +63,12 @@ LevelGameState::LevelGameState(Game & game, std::istream & source)
 
 	guiGameStartButton_ = sfg::Button::Create("Send creeps");
 	guiGameStartButton_->GetSignal(sfg::Button::OnLeftClick).Connect([this]() {
-		levelInstance_->resume();
-		levelInstance_->getInvasionManager().sendNextWave();
+		levelInstance_->sendNextWave();
+	});
+
+	auto guiSaveButton = sfg::Button::Create("Save game");
+	guiSaveButton->GetSignal(sfg::Button::OnLeftClick).Connect([this]() {
+		saveGame(SAVE_PATH);
 	});
 
 	guiInfoPanelLocation_ = sfg::Box::Create(sfg::Box::Orientation::VERTICAL);
@@ -52,6 +80,8 @@ LevelGameState::LevelGameState(Game & game, std::istream & source)
 	guiMainLayout->PackEnd(guiSelectObjectsButton_, false);
 	createTowerCreationButtons(guiMainLayout);
 	guiMainLayout->PackEnd(guiGameStartButton_, false);
+	createSpeedButtons(guiMainLayout);
+	guiMainLayout->PackEnd(guiSaveButton, false);
 	guiMainLayout->PackEnd(guiInfoPanelLocation_, false);
 
 	guiMainWindow_ = sfg::Window::Create(sfg::Window::Style::BACKGROUND);
@@ -80,12 +110,32 @@ LevelGameState::LevelGameState(Game & game, std::istream & source)
 	guiDesktop_.SetProperty( "*", "FontName", "data/FiraSans-Regular.ttf" );
 	guiDesktop_.Add(conguiWindow_);
 
+	debugLabel_ = sfg::Label::Create("");
+	debugLabel_->SetAlignment({ 0.f, 0.f });
+	debugWindow_ = sfg::Window::Create(sfg::Window::Style::BACKGROUND);
+	debugWindow_->Add(debugLabel_);
+	debugWindow_->SetPosition(sf::Vector2f(8.f, 128.f));
+	debugWindow_->Show(false);
+	guiDesktop_.Add(debugWindow_);
+
 	guiDesktop_.Add(guiMainWindow_);
 
 	handleResize(game.getWidth(), game.getHeight());
 	centerView();
 }
 
+LevelGameState::~LevelGameState()
+{
+	levelInstance_->setRecorder(nullptr);
+	levelInstance_->setJobSystem(nullptr);
+	inputLog_.setEndTick(levelInstance_->getTick());
+
+	// Keep the last session around, so that it can be replayed with TDSimulator
+	std::ofstream target(REPLAY_PATH, std::ios::binary);
+	if (target.is_open())
+		inputLog_.write(target);
+}
+
 void LevelGameState::createTowerCreationButtons(const sfg::Box::Ptr & layout)
 {
 	for (const auto & p : TowerFactory::getAllTowerTypeInfos()) {
@@ -104,6 +154,22 @@ void LevelGameState::createTowerCreationButtons(const sfg::Box::Ptr & layout)
 	}
 }
 
+void LevelGameState::createSpeedButtons(const sfg::Box::Ptr & layout)
+{
+	auto speedLayout = sfg::Box::Create(sfg::Box::Orientation::HORIZONTAL);
+
+	for (int32_t speed : { 1, 2, 4, 16, MAX_SPEED }) {
+		auto button = sfg::Button::Create(speed == MAX_SPEED ? "Max" : std::to_string(speed) + "x");
+		button->GetSignal(sfg::Button::OnLeftClick).Connect([this, speed]() {
+			speed_ = speed;
+		});
+
+		speedLayout->PackEnd(button, true);
+	}
+
+	layout->PackEnd(speedLayout, false);
+}
+
 void LevelGameState::centerView()
 {
 	levelView_.setCenter({
@@ -139,7 +205,7 @@ void LevelGameState::handleClick(sf::Vector2i /*position*/, bool isLeft)
 {
 	if(!isLeft)
 		{
-			selectedObject_ = levelInstance_->selectAt(lastMouseLevelPosition_);
+			selectedObject_ = levelRenderer_->selectAt(lastMouseLevelPosition_);
 
 			guiInfoPanelLocation_->RemoveAll();
 			if (std::shared_ptr<Selectable> selectedObject = selectedObject_.lock())
@@ -151,7 +217,7 @@ void LevelGameState::handleClick(sf::Vector2i /*position*/, bool isLeft)
 		// isPlacingTower_ = false;
 	}
 	else if (!isPlacingTower_) {
-		selectedObject_ = levelInstance_->selectAt(lastMouseLevelPosition_);
+		selectedObject_ = levelRenderer_->selectAt(lastMouseLevelPosition_);
 
 		guiInfoPanelLocation_->RemoveAll();
 		if (std::shared_ptr<Selectable> selectedObject = selectedObject_.lock())
@@ -174,6 +240,10 @@ bool LevelGameState::handleKeyPress(sf::Keyboard::Key key)
 	case sf::Keyboard::Down:
 		levelView_.move({ 0.f, 1.f });
 		break;
+	case sf::Keyboard::F3:
+		debugActive_ = !debugActive_;
+		debugWindow_->Show(debugActive_);
+		return true;
 	case sf::Keyboard::Tilde:
 		if(conguiActive_)
 		{
@@ -239,15 +309,22 @@ void LevelGameState::handleCommand(sf::String scmd)
 				return;
 			}
 			float amount = std::strtof(tokens[1].c_str(), nullptr);
-			auto& cr = this->levelInstance_->getCreeps();
-			for(auto& creep : cr)
-			{
-				creep->applyBuff(CreepBuff(5.0f, CreepBuff::Type::BUFF_SPEED, amount));
-			}
+			this->levelInstance_->cheatBuffCreepSpeed(amount);
 		}
 	}
 }
 
+void LevelGameState::saveGame(const std::string & path)
+{
+	try {
+		std::ofstream target(path, std::ios::binary);
+		SavedGame::write(target, *levelInstance_);
+	}
+	catch (std::runtime_error & err) {
+		conguiOutput_->SetText(std::string("Cannot save the game: ") + err.what());
+	}
+}
+
 void LevelGameState::createEndingPopup(const std::string & title, const std::string & content)
 {
 	guiStatusWindow_ = sfg::Window::Create();
@@ -282,7 +359,22 @@ void LevelGameState::update(sf::Time dt)
 	if (!selectedObject_.lock())
 		guiInfoPanelLocation_->RemoveAll();
 	guiDesktop_.Update(dt.asSeconds());
-	levelInstance_->update(dt);
+	if (isFrameRendered_) {
+		frameClock_.restart();
+		isFrameRendered_ = false;
+	}
+
+	// Fast-forward runs several ticks in a row, drawing only the last,
+	// but never for longer than the frame can afford
+	int32_t ticks = 0;
+	do {
+		levelInstance_->update(dt);
+		++ticks;
+	} while ((speed_ == MAX_SPEED || ticks < speed_)
+		&& frameClock_.getElapsedTime() < sf::milliseconds(FRAME_BUDGET_MS)
+		&& !levelInstance_->hasWon() && !levelInstance_->hasLost());
+
+	levelRenderer_->update(dt * (float)ticks);
 
 	auto newCash = levelInstance_->getMoney();
 	if (oldCash_ != newCash) {
@@ -302,6 +394,11 @@ void LevelGameState::update(sf::Time dt)
 		guiWaveLabel_->SetText("Wave: " + std::to_string(newWave));
 	}
 
+	if (newWave > autosavedWave_) {
+		autosavedWave_ = newWave;
+		saveGame(AUTOSAVE_PATH);
+	}
+
 	if (!guiStatusWindow_) {
 		// Check if the game has been won
 		if (levelInstance_->hasWon())
@@ -313,8 +410,9 @@ void LevelGameState::update(sf::Time dt)
 	}
 }
 
-void LevelGameState::render(sf::RenderTarget & target)
+void LevelGameState::render(sf::RenderTarget & target, float interpolation)
 {
+	isFrameRendered_ = true;
 	target.clear(sf::Color::White);
 
 	const auto oldView = target.getView();
@@ -330,7 +428,16 @@ void LevelGameState::render(sf::RenderTarget & target)
 		(int)round(lastMouseLevelPosition_.y)
 	};
 
-	levelInstance_->render(target);
+	levelRenderer_->render(target, interpolation);
+
+	if (debugActive_) {
+		const auto & stats = levelRenderer_->getCullingStats();
+		debugLabel_->SetText(
+			"Tiles: " + std::to_string(stats.visibleTiles) + " visible, "
+			+ std::to_string(stats.culledTiles) + " culled\n"
+			+ "Entities: " + std::to_string(stats.visibleEntities) + " visible, "
+			+ std::to_string(stats.culledEntities) + " culled");
+	}
 
 	if (isPlacingTower_) {
 		sf::CircleShape rs;
@@ -10,7 +10,9 @@
 #include <SFGUI/Widgets.hpp>
 
 #include "GameState.hpp"
+#include "../InputLog.hpp"
 #include "../Level.hpp"
+#include "../LevelRenderer.hpp"
 
 class Game;
 
@@ -20,6 +22,7 @@ private:
 	Game & game_;
 	std::shared_ptr<Level> level_;
 	std::shared_ptr<LevelInstance> levelInstance_;
+	std::unique_ptr<LevelRenderer> levelRenderer_;
 	sfg::Label::Ptr guiCashLabel_;
 	sfg::Label::Ptr guiLivesLabel_;
 	sfg::Label::Ptr guiWaveLabel_;
@@ -44,12 +47,28 @@ private:
 	sfg::Entry::Ptr conguiInput_;
 	bool conguiActive_;
 
+	// Debug overlay
+	sfg::Window::Ptr debugWindow_;
+	sfg::Label::Ptr debugLabel_;
+	bool debugActive_;
+
 	std::weak_ptr<Selectable> selectedObject_;
 
 	std::string placedTowerTypeName_;
 	bool isPlacingTower_;
 
+	//! Ticks of the simulation per tick of the game, 0 for as many as fit.
+	int32_t speed_;
+	//! Measures time spent on updates since the last frame was rendered.
+	sf::Clock frameClock_;
+	bool isFrameRendered_;
+
+	//! Player actions, written out when leaving the level.
+	InputLog inputLog_;
+	int32_t autosavedWave_;
+
 	void createTowerCreationButtons(const sfg::Box::Ptr & layout);
+	void createSpeedButtons(const sfg::Box::Ptr & layout);
 	void centerView();
 
 	void handleResize(int width, int height);
@@ -57,15 +76,25 @@ private:
 	bool handleKeyPress(sf::Keyboard::Key key);
 	void handleCommand(sf::String cmd);
 
+	void saveGame(const std::string & path);
+
 	void createEndingPopup(const std::string & title, const std::string & content);
 	void createWonPopup();
 	void createLostPopup();
 
 public:
+	//! Where the game is saved by the player, and at the start of every wave.
+	static const char * const SAVE_PATH;
+	static const char * const AUTOSAVE_PATH;
+
+	//! Starts the level described by the source.
 	LevelGameState(Game & game, std::istream & source);
+	//! Continues a level in progress, e.g. one read by SavedGame.
+	LevelGameState(Game & game, std::shared_ptr<LevelInstance> levelInstance);
+	virtual ~LevelGameState();
 
 	virtual void update(sf::Time dt) override;
-	virtual void render(sf::RenderTarget & target) override;
+	virtual void render(sf::RenderTarget & target, float interpolation) override;
 	virtual void handleEvent(const sf::Event & evt) override;
 };
 
@@ -90,7 +90,7 @@ void LevelSelectGameState::update(sf::Time dt)
 	guiDesktop_.Update(dt.asSeconds());
 }
 
-void LevelSelectGameState::render(sf::RenderTarget & target)
+void LevelSelectGameState::render(sf::RenderTarget & target, float /*interpolation*/)
 {
 	target.clear();
 }
@@ -27,7 +27,7 @@ public:
 	void setPath(const std::string & path);
 
 	virtual void update(sf::Time dt) override;
-	virtual void render(sf::RenderTarget & target) override;
+	virtual void render(sf::RenderTarget & target, float interpolation) override;
 	virtual void handleEvent(const sf::Event & evt) override;
 
 	void handleResize(int width, int height);
@@ -1,5 +1,8 @@
+#include <fstream>
 #include "../MakeUnique.hpp"
 #include "../Game.hpp"
+#include "../SavedGame.hpp"
+#include "LevelGameState.hpp"
 #include "LevelSelectGameState.hpp"
 #include "MenuGameState.hpp"
 
@@ -19,8 +22,32 @@ MenuGameState::MenuGameState(Game & game)
 	});
 
 	auto guiTable = sfg::Table::Create();
-	guiTable->Attach(guiChooseLevel, { 0, 0, 1, 1 });
-	guiTable->Attach(guiExit, { 0, 1, 1, 1 });
+	sf::Uint32 row = 0;
+	guiTable->Attach(guiChooseLevel, { 0, row++, 1, 1 });
+
+	// Offer saved games, if there are any
+	for (const auto & p : { std::make_pair("Continue", LevelGameState::AUTOSAVE_PATH),
+			std::make_pair("Load game", LevelGameState::SAVE_PATH) }) {
+		const std::string path = p.second;
+		if (!std::ifstream(path).is_open())
+			continue;
+
+		auto button = sfg::Button::Create(p.first);
+		std::weak_ptr<sfg::Button> weakButton = button;
+		button->GetSignal(sfg::Button::OnLeftClick).Connect([this, path, weakButton]() {
+			try {
+				std::ifstream source(path, std::ios::binary);
+				game_.setNextState(std::make_unique<LevelGameState>(game_, SavedGame::read(source)));
+			}
+			catch (std::exception &) {
+				if (auto button = weakButton.lock())
+					button->SetLabel("Cannot load " + path);
+			}
+		});
+		guiTable->Attach(button, { 0, row++, 1, 1 });
+	}
+
+	guiTable->Attach(guiExit, { 0, row++, 1, 1 });
 
 	auto guiWindow = sfg::Window::Create();
 	guiWindow->SetTitle(L"Menu");
@@ -35,7 +62,7 @@ void MenuGameState::update(sf::Time dt)
 	guiDesktop_.Update(dt.asSeconds());
 }
 
-void MenuGameState::render(sf::RenderTarget & target)
+void MenuGameState::render(sf::RenderTarget & target, float /*interpolation*/)
 {
 	target.clear();
 }
@@ -19,7 +19,7 @@ public:
 	virtual ~MenuGameState() {};
 
 	virtual void update(sf::Time dt) override final;
-	virtual void render(sf::RenderTarget & target) override final;
+	virtual void render(sf::RenderTarget & target, float interpolation) override final;
 	virtual void handleEvent(const sf::Event & evt) override final;
 };
 
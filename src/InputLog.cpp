@@ -0,0 +1,275 @@
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include "BinaryStream.hpp"
+#include "Constants.hpp"
+#include "Level.hpp"
+#include "InputLog.hpp"
+
+// Layout of a written log, integers are varints unless noted:
+// "TDIL", format version (1 byte), seed (8 bytes, little endian),
+// start tick, end tick, keyframe interval, entry count, then every entry as:
+// ticks since the previous entry, action (1 byte), action arguments,
+// then keyframe count and every keyframe as ticks since the previous
+// keyframe, count of entries applied before it, and the saved state.
+// Version 2 logs had no start tick nor applied entry counts, and their
+// keyframes hold states of an older snapshot format, so they are dropped
+// and such logs replay from tick 0. Version 1 logs had neither the
+// keyframe interval nor keyframes.
+
+static const char MAGIC[4] = { 'T', 'D', 'I', 'L' };
+static const uint8_t FORMAT_VERSION = 3;
+
+InputLog::InputLog(uint64_t seed, uint64_t keyframeInterval)
+	: seed_(seed)
+	, startTick_(0)
+	, endTick_(0)
+	, keyframeInterval_(keyframeInterval)
+{
+}
+
+InputLog::InputLog(const LevelInstance & start, uint64_t keyframeInterval)
+	: seed_(start.getSeed())
+	, startTick_(start.getTick())
+	, endTick_(start.getTick())
+	, keyframeInterval_(keyframeInterval)
+{
+	recordKeyframe(start);
+}
+
+InputLog::InputLog(std::istream & source)
+{
+	const std::string data((std::istreambuf_iterator<char>(source)), std::istreambuf_iterator<char>());
+	BinaryReader reader(data);
+
+	char magic[sizeof(MAGIC)];
+	reader.readBytes(magic, sizeof(magic));
+	if (memcmp(magic, MAGIC, sizeof(MAGIC)))
+		throw std::runtime_error("Not an input log");
+	const uint8_t version = reader.readByte();
+	if (version < 1 || version > FORMAT_VERSION)
+		throw std::runtime_error("Unsupported input log version");
+
+	seed_ = reader.readFixed(sizeof(seed_));
+	startTick_ = version >= 3 ? reader.readUnsigned() : 0;
+	endTick_ = reader.readUnsigned();
+	keyframeInterval_ = version >= 2 ? reader.readUnsigned() : 0;
+
+	const size_t count = reader.readCount();
+	uint64_t tick = 0;
+	for (size_t i = 0; i < count; ++i) {
+		tick += reader.readUnsigned();
+		const uint8_t action = reader.readByte();
+		if (action > (uint8_t)Action::BUFF_CREEP_SPEED)
+			throw std::runtime_error("Input log contains an unknown action");
+		if (tick < startTick_ || tick > endTick_)
+			throw std::runtime_error("Input log contains an entry outside of its ticks");
+
+		add(tick, (Action)action);
+		entry_t & entry = entries_.back();
+		switch (entry.action) {
+		case Action::CREATE_TOWER:
+			entry.towerName = reader.readString();
+			entry.position = reader.readVector2i();
+			break;
+		case Action::SELL_TOWER:
+			entry.position = reader.readVector2i();
+			break;
+		case Action::ADD_MONEY:
+			entry.amount = reader.readSigned();
+			break;
+		case Action::BUFF_CREEP_SPEED:
+			entry.strength = reader.readFloat();
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (version >= 2) {
+		keyframes_.resize(reader.readCount());
+		tick = 0;
+		for (auto & keyframe : keyframes_) {
+			tick += reader.readUnsigned();
+			keyframe.tick = tick;
+			keyframe.appliedEntries = version >= 3 ? reader.readUnsigned() : 0;
+			if (keyframe.appliedEntries > entries_.size())
+				throw std::runtime_error("Input log contains a keyframe past its entries");
+			keyframe.state = reader.readString();
+		}
+		if (version < 3)
+			keyframes_.clear();
+	}
+
+	if (startTick_ && (keyframes_.empty() || keyframes_.front().tick != startTick_))
+		throw std::runtime_error("Input log does not contain its starting state");
+}
+
+void InputLog::write(std::ostream & target) const
+{
+	BinaryWriter writer;
+	writer.writeBytes(MAGIC, sizeof(MAGIC));
+	writer.writeByte(FORMAT_VERSION);
+	writer.writeFixed(seed_, sizeof(seed_));
+	writer.writeUnsigned(startTick_);
+	writer.writeUnsigned(endTick_);
+	writer.writeUnsigned(keyframeInterval_);
+	writer.writeUnsigned(entries_.size());
+
+	uint64_t tick = 0;
+	for (const auto & entry : entries_) {
+		writer.writeUnsigned(entry.tick - tick);
+		writer.writeByte((uint8_t)entry.action);
+		tick = entry.tick;
+
+		switch (entry.action) {
+		case Action::CREATE_TOWER:
+			writer.writeString(entry.towerName);
+			writer.writeVector(entry.position);
+			break;
+		case Action::SELL_TOWER:
+			writer.writeVector(entry.position);
+			break;
+		case Action::ADD_MONEY:
+			writer.writeSigned(entry.amount);
+			break;
+		case Action::BUFF_CREEP_SPEED:
+			writer.writeFloat(entry.strength);
+			break;
+		default:
+			break;
+		}
+	}
+
+	writer.writeUnsigned(keyframes_.size());
+	tick = 0;
+	for (const auto & keyframe : keyframes_) {
+		writer.writeUnsigned(keyframe.tick - tick);
+		writer.writeUnsigned(keyframe.appliedEntries);
+		writer.writeString(keyframe.state);
+		tick = keyframe.tick;
+	}
+
+	const std::string & buffer = writer.getBuffer();
+	target.write(buffer.data(), buffer.size());
+}
+
+void InputLog::add(uint64_t tick, Action action)
+{
+	if (!entries_.empty() && tick < entries_.back().tick)
+		throw std::logic_error("Input log entries must be recorded in order");
+
+	entry_t entry;
+	entry.tick = tick;
+	entry.action = action;
+	entry.amount = 0;
+	entry.strength = 0.f;
+	entries_.push_back(entry);
+
+	if (endTick_ < tick)
+		endTick_ = tick;
+}
+
+void InputLog::recordTowerCreated(uint64_t tick, const std::string & towerName, sf::Vector2i position)
+{
+	add(tick, Action::CREATE_TOWER);
+	entries_.back().towerName = towerName;
+	entries_.back().position = position;
+}
+
+void InputLog::recordTowerSold(uint64_t tick, sf::Vector2i position)
+{
+	add(tick, Action::SELL_TOWER);
+	entries_.back().position = position;
+}
+
+void InputLog::recordResume(uint64_t tick)
+{
+	add(tick, Action::RESUME);
+}
+
+void InputLog::recordNextWave(uint64_t tick)
+{
+	add(tick, Action::SEND_NEXT_WAVE);
+}
+
+void InputLog::recordMoneyAdded(uint64_t tick, int64_t amount)
+{
+	add(tick, Action::ADD_MONEY);
+	entries_.back().amount = amount;
+}
+
+void InputLog::recordCreepSpeedBuff(uint64_t tick, float strength)
+{
+	add(tick, Action::BUFF_CREEP_SPEED);
+	entries_.back().strength = strength;
+}
+
+void InputLog::recordKeyframe(const LevelInstance & levelInstance)
+{
+	BinaryWriter writer;
+	levelInstance.save(writer);
+	keyframes_.push_back({ levelInstance.getTick(), entries_.size(), writer.takeBuffer() });
+
+	if (endTick_ < levelInstance.getTick())
+		endTick_ = levelInstance.getTick();
+}
+
+size_t InputLog::apply(LevelInstance & levelInstance, size_t from) const
+{
+	const uint64_t tick = levelInstance.getTick();
+	for (; from < entries_.size() && entries_[from].tick <= tick; ++from) {
+		const entry_t & entry = entries_[from];
+		switch (entry.action) {
+		case Action::CREATE_TOWER:
+			if (levelInstance.canPlaceTowerHere(entry.position))
+				levelInstance.createTowerAt(entry.towerName, entry.position);
+			break;
+		case Action::SELL_TOWER:
+			levelInstance.sellTower(levelInstance.getTowerAt(entry.position));
+			break;
+		case Action::RESUME:
+			levelInstance.resume();
+			break;
+		case Action::SEND_NEXT_WAVE:
+			levelInstance.sendNextWave();
+			break;
+		case Action::ADD_MONEY:
+			levelInstance.cheatAddMoney(entry.amount);
+			break;
+		case Action::BUFF_CREEP_SPEED:
+			levelInstance.cheatBuffCreepSpeed(entry.strength);
+			break;
+		}
+	}
+
+	return from;
+}
+
+size_t InputLog::seek(LevelInstance & levelInstance, uint64_t tick) const
+{
+	auto byTick = [](uint64_t tick, const keyframe_t & keyframe) {
+		return tick < keyframe.tick;
+	};
+	tick = std::min(tick, endTick_);
+
+	size_t from = 0;
+	const auto keyframe = std::upper_bound(keyframes_.begin(), keyframes_.end(), tick, byTick);
+	if (keyframe != keyframes_.begin()) {
+		BinaryReader reader(std::prev(keyframe)->state);
+		levelInstance.load(reader);
+		from = (size_t)std::prev(keyframe)->appliedEntries;
+	}
+	else if (levelInstance.getTick() != 0 || startTick_ != 0) {
+		throw std::logic_error("Seeking without a keyframe needs a fresh LevelInstance");
+	}
+
+	const sf::Time dt = sf::seconds(Constants::SECONDS_PER_FRAME);
+	while (levelInstance.getTick() < tick && !levelInstance.hasWon() && !levelInstance.hasLost()) {
+		from = apply(levelInstance, from);
+		levelInstance.update(dt);
+	}
+
+	return from;
+}
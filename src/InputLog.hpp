@@ -0,0 +1,139 @@
+#pragma once
+
+#ifndef TDF_INPUT_LOG_HPP
+#define TDF_INPUT_LOG_HPP
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <SFML/System.hpp>
+
+class LevelInstance;
+
+//! \brief Everything a player did during a level, and at which tick.
+//! Together with the seed and the level it is enough to play the level
+//! again exactly as it went, e.g. headlessly in the batch simulator.
+//! LevelInstance records its input here when given a log with setRecorder.
+//! The log can also keep snapshots of the whole LevelInstance taken every
+//! few ticks, so that seeking into a replay does not simulate it from the start.
+class InputLog
+{
+public:
+	enum class Action : uint8_t
+	{
+		CREATE_TOWER,
+		SELL_TOWER,
+		RESUME,
+		SEND_NEXT_WAVE,
+		ADD_MONEY,
+		BUFF_CREEP_SPEED
+	};
+
+	struct entry_t
+	{
+		uint64_t tick;
+		Action action;
+		sf::Vector2i position;
+		std::string towerName;
+		int64_t amount;
+		float strength;
+	};
+
+	//! State saved by LevelInstance::save, after the given number of entries was applied.
+	struct keyframe_t
+	{
+		uint64_t tick;
+		uint64_t appliedEntries;
+		std::string state;
+	};
+
+private:
+	uint64_t seed_;
+	uint64_t startTick_;
+	uint64_t endTick_;
+	uint64_t keyframeInterval_;
+	std::vector<entry_t> entries_;
+	std::vector<keyframe_t> keyframes_;
+
+	void add(uint64_t tick, Action action);
+
+public:
+	//! Creates an empty log, which asks for a keyframe every keyframeInterval ticks, or never if 0.
+	explicit InputLog(uint64_t seed, uint64_t keyframeInterval = 0);
+
+	//! \brief Creates an empty log starting from the current state of a LevelInstance,
+	//! e.g. one loaded from a saved game. The state is kept as the first keyframe.
+	InputLog(const LevelInstance & start, uint64_t keyframeInterval);
+
+	//! Reads a log written by write, throws std::runtime_error if it is malformed.
+	InputLog(std::istream & source);
+
+	//! Writes the log in a compact binary form.
+	void write(std::ostream & target) const;
+
+	uint64_t getSeed() const
+	{
+		return seed_;
+	}
+
+	//! Returns the tick at which recording started, 0 unless it started from a saved state.
+	uint64_t getStartTick() const
+	{
+		return startTick_;
+	}
+
+	//! Returns the tick at which the recorded session ended.
+	uint64_t getEndTick() const
+	{
+		return endTick_;
+	}
+
+	void setEndTick(uint64_t tick)
+	{
+		endTick_ = tick;
+	}
+
+	const std::vector<entry_t> & getEntries() const
+	{
+		return entries_;
+	}
+
+	const std::vector<keyframe_t> & getKeyframes() const
+	{
+		return keyframes_;
+	}
+
+	//! Tells if LevelInstance should record a keyframe at the given tick.
+	bool needsKeyframe(uint64_t tick) const
+	{
+		return keyframeInterval_ && tick % keyframeInterval_ == 0
+			&& (keyframes_.empty() || keyframes_.back().tick < tick);
+	}
+
+	void recordKeyframe(const LevelInstance & levelInstance);
+
+	void recordTowerCreated(uint64_t tick, const std::string & towerName, sf::Vector2i position);
+	void recordTowerSold(uint64_t tick, sf::Vector2i position);
+	void recordResume(uint64_t tick);
+	void recordNextWave(uint64_t tick);
+	void recordMoneyAdded(uint64_t tick, int64_t amount);
+	void recordCreepSpeedBuff(uint64_t tick, float strength);
+
+	//! \brief Repeats entries recorded for the current tick of the LevelInstance,
+	//! starting from the given index. Returns the index of the first entry
+	//! which was not applied.
+	size_t apply(LevelInstance & levelInstance, size_t from) const;
+
+	//! \brief Brings the LevelInstance to the beginning of the given tick, by loading
+	//! the closest keyframe before it and simulating the rest. Without such a keyframe
+	//! the LevelInstance has to be at tick 0, and the log has to start there. Stops
+	//! early where the game was won or lost, or where the log ends; getTick of the
+	//! LevelInstance tells where. Returns the index of the first entry which was not
+	//! applied, for use with apply.
+	size_t seek(LevelInstance & levelInstance, uint64_t tick) const;
+};
+
+#endif // TDF_INPUT_LOG_HPP
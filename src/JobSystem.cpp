@@ -0,0 +1,278 @@
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include "JobSystem.hpp"
+
+// The slot of the current thread, in the JobSystem it works for
+static thread_local const JobSystem * currentSystem = nullptr;
+static thread_local uint32_t currentSlotIndex = 0;
+
+// Tasks run while waiting inside another task count as busy time of the outer one
+static thread_local uint32_t taskDepth = 0;
+
+size_t TaskGraph::add(std::function<void()> function, std::initializer_list<size_t> after)
+{
+	const size_t id = nodes_.size();
+	for (size_t dependency : after) {
+		if (dependency >= id)
+			throw std::logic_error("A task can only depend on tasks added before it");
+	}
+
+	nodes_.emplace_back(std::move(function));
+	for (size_t dependency : after)
+		nodes_[dependency].dependents.push_back(id);
+	nodes_.back().dependencies = after.size();
+	return id;
+}
+
+void TaskGraph::run()
+{
+	for (auto & node : nodes_)
+		node.function();
+}
+
+JobSystem::JobSystem(uint32_t workerCount)
+	: queued_(0)
+	, stopping_(false)
+	, statsStart_(clock_t::now())
+{
+	for (uint32_t i = 0; i <= workerCount; ++i)
+		slots_.emplace_back(new slot_t());
+
+	workers_.reserve(workerCount);
+	for (uint32_t i = 1; i <= workerCount; ++i)
+		workers_.emplace_back([this, i]() { runWorker(i); });
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex_);
+		stopping_ = true;
+	}
+	wakeWorkers_.notify_all();
+
+	for (auto & worker : workers_)
+		worker.join();
+}
+
+uint32_t JobSystem::getDefaultWorkerCount()
+{
+	const uint32_t cores = std::thread::hardware_concurrency();
+	return cores > 1 ? cores - 1 : 0;
+}
+
+uint32_t JobSystem::currentSlot() const
+{
+	return currentSystem == this ? currentSlotIndex : 0;
+}
+
+void JobSystem::push(uint32_t slot, const task_t & task)
+{
+	{
+		std::lock_guard<std::mutex> lock(slots_[slot]->mutex);
+		slots_[slot]->tasks.push_back(task);
+	}
+	++queued_;
+}
+
+void JobSystem::wake(bool all)
+{
+	if (workers_.empty())
+		return;
+
+	// Taking the lock orders the wake up after workers checked queued_
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex_);
+	}
+	if (all)
+		wakeWorkers_.notify_all();
+	else
+		wakeWorkers_.notify_one();
+}
+
+bool JobSystem::take(uint32_t slot, task_t & task, const group_t * group)
+{
+	if (queued_ == 0)
+		return false;
+
+	auto matches = [&](const task_t & queued) {
+		return !group || queued.group == group;
+	};
+
+	// The newest task of our own, which is likely still in cache
+	{
+		slot_t & own = *slots_[slot];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		const auto found = std::find_if(own.tasks.rbegin(), own.tasks.rend(), matches);
+		if (found != own.tasks.rend()) {
+			task = *found;
+			own.tasks.erase(std::next(found).base());
+			--queued_;
+			return true;
+		}
+	}
+
+	// Otherwise the oldest task of another thread, which likely splits into most work
+	for (size_t i = 1; i < slots_.size(); ++i) {
+		slot_t & victim = *slots_[(slot + i) % slots_.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		const auto found = std::find_if(victim.tasks.begin(), victim.tasks.end(), matches);
+		if (found != victim.tasks.end()) {
+			task = *found;
+			victim.tasks.erase(found);
+			--queued_;
+			++slots_[slot]->steals;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void JobSystem::execute(uint32_t slot, const task_t & task)
+{
+	group_t & group = *task.group;
+	const auto start = clock_t::now();
+
+	if (!group.failed) {
+		++taskDepth;
+		try {
+			if (task.range)
+				(*task.range)(task.begin, task.end);
+			else
+				task.graph->nodes_[task.node].function();
+		}
+		catch (...) {
+			std::lock_guard<std::mutex> lock(group.mutex);
+			if (!group.error)
+				group.error = std::current_exception();
+			group.failed = true;
+		}
+		--taskDepth;
+	}
+
+	slot_t & own = *slots_[slot];
+	++own.taskCount;
+	if (taskDepth == 0)
+		own.busyNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(clock_t::now() - start).count();
+
+	// Dependents of a failed task are still released, so that they get skipped
+	if (task.graph) {
+		size_t released = 0;
+		for (size_t dependent : task.graph->nodes_[task.node].dependents) {
+			if (--task.graph->nodes_[dependent].remaining == 0) {
+				push(slot, { &group, nullptr, 0, 0, task.graph, dependent });
+				++released;
+			}
+		}
+		if (released)
+			wake(released > 1);
+	}
+
+	--group.pending;
+}
+
+void JobSystem::waitFor(uint32_t slot, group_t & group)
+{
+	task_t task;
+	while (group.pending != 0) {
+		if (take(slot, task, &group))
+			execute(slot, task);
+		else
+			std::this_thread::yield();
+	}
+
+	if (group.error)
+		std::rethrow_exception(group.error);
+}
+
+void JobSystem::runWorker(uint32_t slot)
+{
+	currentSystem = this;
+	currentSlotIndex = slot;
+
+	task_t task;
+	for (;;) {
+		if (take(slot, task, nullptr)) {
+			execute(slot, task);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(sleepMutex_);
+		if (stopping_)
+			return;
+		if (queued_ == 0)
+			wakeWorkers_.wait(lock);
+	}
+}
+
+void JobSystem::parallelFor(size_t count, size_t grain, const range_function_t & f)
+{
+	grain = std::max<size_t>(grain, 1);
+	const size_t chunks = (count + grain - 1) / grain;
+	if (chunks == 0)
+		return;
+
+	const uint32_t slot = currentSlot();
+	group_t group(chunks);
+
+	// Without workers the ranges run in order; otherwise they are queued so
+	// that the first range is taken first, and the last ones are stolen
+	if (workers_.empty() || chunks == 1) {
+		for (size_t begin = 0; begin < count; begin += grain)
+			execute(slot, { &group, &f, begin, std::min(count, begin + grain), nullptr, 0 });
+	}
+	else {
+		for (size_t chunk = chunks; chunk-- > 0;) {
+			const size_t begin = chunk * grain;
+			push(slot, { &group, &f, begin, std::min(count, begin + grain), nullptr, 0 });
+		}
+		wake(true);
+	}
+
+	waitFor(slot, group);
+}
+
+void JobSystem::run(TaskGraph & graph)
+{
+	if (graph.nodes_.empty())
+		return;
+
+	const uint32_t slot = currentSlot();
+	group_t group(graph.nodes_.size());
+	for (auto & node : graph.nodes_)
+		node.remaining = node.dependencies;
+
+	// Queued so that the first task added is taken first
+	for (size_t i = graph.nodes_.size(); i-- > 0;) {
+		if (graph.nodes_[i].dependencies == 0)
+			push(slot, { &group, nullptr, 0, 0, &graph, i });
+	}
+	wake(true);
+
+	waitFor(slot, group);
+}
+
+std::vector<JobSystem::worker_stats_t> JobSystem::getStats() const
+{
+	std::vector<worker_stats_t> stats;
+	for (const auto & slot : slots_)
+		stats.push_back({ slot->taskCount, slot->steals, slot->busyNanoseconds * 1e-9 });
+	return stats;
+}
+
+double JobSystem::getStatsSeconds() const
+{
+	return std::chrono::duration<double>(clock_t::now() - statsStart_).count();
+}
+
+void JobSystem::resetStats()
+{
+	for (auto & slot : slots_) {
+		slot->taskCount = 0;
+		slot->steals = 0;
+		slot->busyNanoseconds = 0;
+	}
+	statsStart_ = clock_t::now();
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#ifndef TDF_JOB_SYSTEM_HPP
+#define TDF_JOB_SYSTEM_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//! \brief Tasks with dependencies between them, run by JobSystem::run.
+//! A task may only depend on tasks added before it, so graphs have no cycles.
+//! The same graph can be run again, but not twice at the same time.
+class TaskGraph
+{
+	friend class JobSystem;
+
+private:
+	struct node_t
+	{
+		std::function<void()> function;
+		std::vector<size_t> dependents;
+		size_t dependencies;
+		std::atomic<size_t> remaining;
+
+		explicit node_t(std::function<void()> function)
+			: function(std::move(function))
+			, dependencies(0)
+			, remaining(0)
+		{}
+	};
+
+	std::deque<node_t> nodes_;
+
+public:
+	//! \brief Adds a task which runs once the given tasks finished, returns its id.
+	//! Throws std::logic_error if a given id is not in the graph.
+	size_t add(std::function<void()> function, std::initializer_list<size_t> after = {});
+
+	size_t size() const
+	{
+		return nodes_.size();
+	}
+
+	//! Runs all tasks on the calling thread, in the order they were added.
+	void run();
+};
+
+//! \brief A pool of worker threads running simulation phases in parallel.
+//! Every thread keeps its own queue of tasks and steals tasks of the others
+//! once it runs out. A thread waiting for a job to finish runs the queued
+//! tasks of that job meanwhile, so tasks may start and wait for jobs of
+//! their own. The calling thread takes part in every job, so a JobSystem
+//! without workers runs everything serially, on the calling thread, and
+//! always in the same order.
+class JobSystem
+{
+public:
+	//! Called with a range [begin, end) of indices to process.
+	typedef std::function<void(size_t begin, size_t end)> range_function_t;
+
+	//! What a thread did since the last resetStats.
+	struct worker_stats_t
+	{
+		uint64_t tasks;
+		uint64_t steals;
+		double busySeconds;
+	};
+
+private:
+	typedef std::chrono::steady_clock clock_t;
+
+	//! Tasks started together, which are waited for together.
+	struct group_t
+	{
+		std::atomic<size_t> pending;
+		std::atomic<bool> failed;
+		std::mutex mutex;
+		std::exception_ptr error;
+
+		explicit group_t(size_t pending)
+			: pending(pending)
+			, failed(false)
+		{}
+	};
+
+	//! Either a range of a parallelFor, or a task of a TaskGraph.
+	struct task_t
+	{
+		group_t * group;
+		const range_function_t * range;
+		size_t begin, end;
+		TaskGraph * graph;
+		size_t node;
+	};
+
+	//! A thread taking part in jobs; slot 0 is shared by threads outside of the system.
+	struct slot_t
+	{
+		std::mutex mutex;
+		//! Oldest first. Queues are short, so taking from the front of a vector
+		//! is cheap, and unlike a deque it keeps its storage once it grew.
+		std::vector<task_t> tasks;
+		std::atomic<uint64_t> taskCount, steals, busyNanoseconds;
+
+		slot_t() : taskCount(0), steals(0), busyNanoseconds(0) {}
+	};
+
+	std::vector<std::unique_ptr<slot_t>> slots_;
+	std::vector<std::thread> workers_;
+
+	std::mutex sleepMutex_;
+	std::condition_variable wakeWorkers_;
+	std::atomic<size_t> queued_;
+	bool stopping_;
+
+	clock_t::time_point statsStart_;
+
+	uint32_t currentSlot() const;
+	void push(uint32_t slot, const task_t & task);
+	void wake(bool all);
+
+	//! Takes a task of the given slot, or steals one from the others; only of the group if given.
+	bool take(uint32_t slot, task_t & task, const group_t * group);
+	void execute(uint32_t slot, const task_t & task);
+
+	//! Runs queued tasks until all tasks of the group finished, then rethrows their first exception.
+	void waitFor(uint32_t slot, group_t & group);
+	void runWorker(uint32_t slot);
+
+public:
+	//! Starts the given number of worker threads, 0 for a serial JobSystem.
+	explicit JobSystem(uint32_t workerCount);
+	~JobSystem();
+
+	JobSystem(const JobSystem &) = delete;
+	JobSystem & operator=(const JobSystem &) = delete;
+
+	//! Returns a worker count which keeps every core of the machine busy.
+	static uint32_t getDefaultWorkerCount();
+
+	uint32_t getWorkerCount() const
+	{
+		return (uint32_t)workers_.size();
+	}
+
+	//! \brief Calls f on ranges of at most grain indices covering [0, count),
+	//! and returns once all of them finished. Ranges run in no particular
+	//! order, unless the JobSystem has no workers. Once f threw, ranges which
+	//! did not start yet are skipped, and the exception is rethrown here.
+	void parallelFor(size_t count, size_t grain, const range_function_t & f);
+
+	//! \brief Runs the tasks of the graph, each once all tasks it depends on
+	//! finished, and returns once all of them finished. Once a task threw,
+	//! tasks which did not start yet are skipped, and the exception is
+	//! rethrown here.
+	void run(TaskGraph & graph);
+
+	//! \brief Returns counters of every thread since the last resetStats,
+	//! the threads outside of the system first, then every worker.
+	std::vector<worker_stats_t> getStats() const;
+
+	//! Returns how long ago the counters were reset.
+	double getStatsSeconds() const;
+
+	void resetStats();
+};
+
+#endif // TDF_JOB_SYSTEM_HPP
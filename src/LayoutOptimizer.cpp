@@ -0,0 +1,311 @@
+#include <algorithm>
+#include <cmath>
+#include "BinaryStream.hpp"
+#include "Constants.hpp"
+#include "JobSystem.hpp"
+#include "LayoutOptimizer.hpp"
+#include "Level.hpp"
+#include "Tower/TowerFactory.hpp"
+
+// Creeps are counted into the heat every few ticks, which is enough to see where they walk
+static const int64_t HEAT_INTERVAL = 10;
+
+// Positions are ranked by the heat of cells a basic Tower reaches from them
+static const int32_t HEAT_RADIUS = 3;
+
+bool LayoutOptimizer::score_t::isBetterThan(const score_t & other) const
+{
+	if (lives != other.lives)
+		return lives > other.lives;
+	if (winRate != other.winRate)
+		return winRate > other.winRate;
+	// Holding out longer only helps games which are lost anyway
+	if (winRate < 1.0 && ticks != other.ticks)
+		return ticks > other.ticks;
+	return spent < other.spent;
+}
+
+LayoutOptimizer::LayoutOptimizer(std::shared_ptr<Level> level, const settings_t & settings)
+	: level_(level)
+	, settings_(settings)
+{
+}
+
+LayoutOptimizer::game_t LayoutOptimizer::play(const std::string & snapshot, uint64_t seed, const extension_t * extension) const
+{
+	const int32_t width = level_->getWidth();
+	const int32_t height = level_->getHeight();
+
+	game_t game;
+	game.placed = !extension;
+	game.placedAt = -1;
+	if (!extension)
+		game.snapshot = snapshot;
+
+	auto levelInstance = std::make_shared<LevelInstance>(level_, seed);
+	BinaryReader reader(snapshot);
+	levelInstance->load(reader);
+	game.startedAt = (int64_t)levelInstance->getTick();
+
+	std::vector<uint32_t> heat(width * height, 0);
+	const auto & creeps = levelInstance->getCreeps();
+	const sf::Time dt = sf::seconds(Constants::SECONDS_PER_FRAME);
+
+	while ((int64_t)levelInstance->getTick() < settings_.maxTicks
+		&& !levelInstance->hasWon() && !levelInstance->hasLost()) {
+		const int64_t tick = (int64_t)levelInstance->getTick();
+
+		if (!game.placed && levelInstance->getMoney() >= extension->cost
+			&& levelInstance->canPlaceTowerHere(extension->position)
+			&& levelInstance->createTowerAt(extension->towerName, extension->position)) {
+			game.placed = true;
+			game.placedAt = tick;
+
+			BinaryWriter writer;
+			levelInstance->save(writer);
+			game.snapshot = writer.takeBuffer();
+		}
+
+		if (tick % HEAT_INTERVAL == 0) {
+			for (const auto & position : creeps.getPositions()) {
+				const int32_t x = std::max(0, std::min(width - 1, (int32_t)std::lround(position.x)));
+				const int32_t y = std::max(0, std::min(height - 1, (int32_t)std::lround(position.y)));
+				++heat[y * width + x];
+			}
+		}
+
+		levelInstance->update(dt);
+	}
+
+	game.won = levelInstance->hasWon();
+	game.lives = levelInstance->getLives();
+	game.ticks = (int64_t)levelInstance->getTick();
+	game.heat.swap(heat);
+	return game;
+}
+
+LayoutOptimizer::game_t LayoutOptimizer::replay(const TowerLayout & layout, uint64_t seed) const
+{
+	game_t game;
+	game.placed = true;
+	game.startedAt = 0;
+	game.placedAt = -1;
+
+	auto levelInstance = std::make_shared<LevelInstance>(level_, seed);
+	levelInstance->resume();
+
+	const sf::Time dt = sf::seconds(Constants::SECONDS_PER_FRAME);
+	while ((int64_t)levelInstance->getTick() < settings_.maxTicks
+		&& !levelInstance->hasWon() && !levelInstance->hasLost()) {
+		layout.apply(*levelInstance, (int64_t)levelInstance->getTick());
+		levelInstance->update(dt);
+	}
+
+	game.won = levelInstance->hasWon();
+	game.lives = levelInstance->getLives();
+	game.ticks = (int64_t)levelInstance->getTick();
+	return game;
+}
+
+bool LayoutOptimizer::collect(std::vector<game_t> & games, size_t first, candidate_t & candidate) const
+{
+	const size_t count = settings_.seeds.size();
+	std::vector<uint32_t> heat(level_->getWidth() * level_->getHeight(), 0);
+
+	double lives = 0.0, wins = 0.0, ticks = 0.0;
+	for (size_t i = first; i < first + count; ++i) {
+		game_t & game = games[i];
+		if (!game.placed)
+			return false;
+
+		lives += game.lives;
+		wins += game.won;
+		ticks += game.ticks;
+		for (size_t cell = 0; cell < heat.size(); ++cell)
+			heat[cell] += game.heat[cell];
+		candidate.snapshots.push_back(std::move(game.snapshot));
+	}
+
+	candidate.score.lives = lives / count;
+	candidate.score.winRate = wins / count;
+	candidate.score.ticks = ticks / count;
+	for (size_t cell = 0; cell < heat.size(); ++cell) {
+		if (heat[cell])
+			candidate.heat.push_back({ (int32_t)cell, heat[cell] });
+	}
+	return true;
+}
+
+void LayoutOptimizer::listExtensions(const candidate_t & candidate, size_t parent, std::vector<extension_t> & extensions) const
+{
+	if (candidate.layout.getPlacements().size() >= settings_.maxTowers)
+		return;
+
+	const int32_t width = level_->getWidth();
+	const int32_t height = level_->getHeight();
+
+	// How busy the surroundings of every cell are
+	std::vector<uint64_t> busy(width * height, 0);
+	for (const auto & cellHeat : candidate.heat) {
+		const int32_t cx = cellHeat.first % width;
+		const int32_t cy = cellHeat.first / width;
+		for (int32_t y = std::max(0, cy - HEAT_RADIUS); y <= std::min(height - 1, cy + HEAT_RADIUS); ++y) {
+			for (int32_t x = std::max(0, cx - HEAT_RADIUS); x <= std::min(width - 1, cx + HEAT_RADIUS); ++x) {
+				if ((x - cx) * (x - cx) + (y - cy) * (y - cy) <= HEAT_RADIUS * HEAT_RADIUS)
+					busy[y * width + x] += cellHeat.second;
+			}
+		}
+	}
+
+	// Placement is checked in the game of the first seed, where Creeps stand
+	// almost where they do with the others; play() checks it again anyway
+	auto levelInstance = std::make_shared<LevelInstance>(level_, settings_.seeds.front());
+	BinaryReader reader(candidate.snapshots.front());
+	levelInstance->load(reader);
+
+	std::vector<int32_t> cells;
+	for (int32_t cell = 0; cell < width * height; ++cell) {
+		if (busy[cell] && levelInstance->canPlaceTowerHere({ cell % width, cell / width }))
+			cells.push_back(cell);
+	}
+	std::stable_sort(cells.begin(), cells.end(), [&](int32_t a, int32_t b) {
+		return busy[a] > busy[b];
+	});
+	if (cells.size() > settings_.positions)
+		cells.resize(settings_.positions);
+
+	const int64_t left = settings_.budget - candidate.score.spent;
+	for (const auto & typeInfo : TowerFactory::getAllTowerTypeInfos()) {
+		if (typeInfo.second.cost > left)
+			continue;
+		for (int32_t cell : cells)
+			extensions.push_back({ parent, typeInfo.first, typeInfo.second.cost, { cell % width, cell / width } });
+	}
+}
+
+LayoutOptimizer::candidate_t LayoutOptimizer::optimize(JobSystem & jobs, const progress_function_t & progress) const
+{
+	const auto & seeds = settings_.seeds;
+	const size_t seedCount = seeds.size();
+
+	// Games without Towers, saved right after they started
+	std::vector<std::string> starts;
+	for (uint64_t seed : seeds) {
+		auto levelInstance = std::make_shared<LevelInstance>(level_, seed);
+		levelInstance->resume();
+		BinaryWriter writer;
+		levelInstance->save(writer);
+		starts.push_back(writer.takeBuffer());
+	}
+
+	std::vector<game_t> games(seedCount);
+	jobs.parallelFor(seedCount, 1, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			games[i] = play(starts[i], seeds[i], nullptr);
+	});
+
+	candidate_t root;
+	root.score.spent = 0;
+	collect(games, 0, root);
+
+	stats_t stats;
+	stats.step = 0;
+	stats.layouts = 1;
+	stats.games = 0;
+	stats.playedTicks = 0;
+	stats.reusedTicks = 0;
+	const auto count = [&stats](const std::vector<game_t> & played) {
+		stats.games += played.size();
+		for (const auto & game : played) {
+			stats.playedTicks += game.ticks - game.startedAt;
+			stats.reusedTicks += game.startedAt;
+		}
+	};
+	count(games);
+	if (progress)
+		progress(stats, root);
+
+	candidate_t best = root;
+	std::vector<candidate_t> beam;
+	beam.push_back(std::move(root));
+
+	for (size_t step = 1; step <= settings_.maxTowers; ++step) {
+		std::vector<extension_t> extensions;
+		for (size_t i = 0; i < beam.size(); ++i)
+			listExtensions(beam[i], i, extensions);
+		if (extensions.empty())
+			break;
+
+		// Every extension continues the games of its parent from its last Tower
+		games.assign(extensions.size() * seedCount, game_t());
+		jobs.parallelFor(games.size(), 1, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				const extension_t & extension = extensions[i / seedCount];
+				const size_t seed = i % seedCount;
+				games[i] = play(beam[extension.parent].snapshots[seed], seeds[seed], &extension);
+			}
+		});
+		stats.step = step;
+		stats.layouts += extensions.size();
+		count(games);
+
+		std::vector<candidate_t> children;
+		for (size_t i = 0; i < extensions.size(); ++i) {
+			const extension_t & extension = extensions[i];
+			candidate_t child;
+			child.score.spent = beam[extension.parent].score.spent + extension.cost;
+			if (!collect(games, i * seedCount, child))
+				continue;
+
+			// Seeds may afford the Tower at different ticks; by the last of them all can
+			TowerLayout::placement_t placement;
+			placement.tick = 0;
+			for (size_t seed = 0; seed < seedCount; ++seed)
+				placement.tick = std::max(placement.tick, games[i * seedCount + seed].placedAt);
+			placement.towerName = extension.towerName;
+			placement.position = extension.position;
+
+			child.layout = beam[extension.parent].layout;
+			child.layout.addPlacement(placement);
+			children.push_back(std::move(child));
+		}
+		if (children.empty())
+			break;
+
+		std::stable_sort(children.begin(), children.end(), [](const candidate_t & a, const candidate_t & b) {
+			return a.score.isBetterThan(b.score);
+		});
+		if (children.size() > settings_.beamWidth)
+			children.resize(settings_.beamWidth);
+
+		const bool improved = children.front().score.isBetterThan(best.score);
+		if (improved)
+			best = children.front();
+		if (progress)
+			progress(stats, best);
+		if (!improved)
+			break;
+
+		beam.swap(children);
+	}
+
+	// Seeds which could afford a Tower earlier than the layout lists get it
+	// later than in the search, so the layout is scored as it will be played
+	games.assign(seedCount, game_t());
+	jobs.parallelFor(seedCount, 1, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			games[i] = replay(best.layout, seeds[i]);
+	});
+
+	double lives = 0.0, wins = 0.0, ticks = 0.0;
+	for (const auto & game : games) {
+		lives += game.lives;
+		wins += game.won;
+		ticks += game.ticks;
+	}
+	best.score.lives = lives / seedCount;
+	best.score.winRate = wins / seedCount;
+	best.score.ticks = ticks / seedCount;
+
+	return best;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#ifndef TDF_LAYOUT_OPTIMIZER_HPP
+#define TDF_LAYOUT_OPTIMIZER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <SFML/System.hpp>
+
+#include "TowerLayout.hpp"
+
+class JobSystem;
+class Level;
+
+//! \brief Searches for a TowerLayout which keeps as many lives as possible
+//! within a money budget, by playing candidate layouts headlessly.
+//! Layouts grow one Tower at a time with a beam search, a greedy one when
+//! the beam is a single layout wide. Towers are placed as soon as there is
+//! money for them and the placement oracle allows it. Every layout keeps
+//! the state of its games right after its last Tower was placed, so that
+//! layouts extending it continue from there instead of from the start.
+class LayoutOptimizer
+{
+public:
+	struct settings_t
+	{
+		//! Every layout is played once with each seed.
+		std::vector<uint64_t> seeds;
+		//! How much money all Towers may cost together.
+		int64_t budget;
+		//! How many layouts are extended at every step.
+		size_t beamWidth;
+		//! How many positions are tried for every type of Tower, the busiest first.
+		size_t positions;
+		//! How many Towers a layout may have.
+		size_t maxTowers;
+		int64_t maxTicks;
+	};
+
+	//! How a layout fared, averaged over the seeds.
+	struct score_t
+	{
+		double lives;
+		double winRate;
+		double ticks;
+		int64_t spent;
+
+		//! \brief Orders by lives kept and wins, then by how long the games
+		//! lasted unless all of them were won, then by cheapness.
+		bool isBetterThan(const score_t & other) const;
+	};
+
+	struct candidate_t
+	{
+		TowerLayout layout;
+		score_t score;
+		//! State of the game of every seed, right after the last Tower was placed.
+		std::vector<std::string> snapshots;
+		//! How often Creeps were seen in each cell of the level, as (cell, count) pairs.
+		std::vector<std::pair<int32_t, uint32_t>> heat;
+	};
+
+	//! How much work the search did so far.
+	struct stats_t
+	{
+		size_t step;
+		size_t layouts;
+		size_t games;
+		//! Ticks simulated, and ticks which did not need to be thanks to snapshots.
+		int64_t playedTicks;
+		int64_t reusedTicks;
+	};
+
+	//! Called after every step with the best layout found so far.
+	typedef std::function<void(const stats_t & stats, const candidate_t & best)> progress_function_t;
+
+private:
+	//! What playing a layout with a single seed showed.
+	struct game_t
+	{
+		bool placed;
+		int64_t startedAt;
+		int64_t placedAt;
+		std::string snapshot;
+		bool won;
+		int64_t lives;
+		int64_t ticks;
+		//! How often Creeps were seen in each cell of the level.
+		std::vector<uint32_t> heat;
+	};
+
+	//! A layout of the beam with one more Tower.
+	struct extension_t
+	{
+		size_t parent;
+		std::string towerName;
+		int32_t cost;
+		sf::Vector2i position;
+	};
+
+	std::shared_ptr<Level> level_;
+	settings_t settings_;
+
+	//! \brief Continues a game from the snapshot until it ends, placing the
+	//! given Tower first, if any, as soon as possible.
+	game_t play(const std::string & snapshot, uint64_t seed, const extension_t * extension) const;
+
+	//! Plays a game from the start, building the Towers of the layout at their ticks.
+	game_t replay(const TowerLayout & layout, uint64_t seed) const;
+
+	//! \brief Moves games of all seeds, starting at first, into the candidate.
+	//! Returns false if the Tower could not be placed in one of them.
+	bool collect(std::vector<game_t> & games, size_t first, candidate_t & candidate) const;
+
+	//! Lists Towers worth adding to the candidate, positions near busy cells first.
+	void listExtensions(const candidate_t & candidate, size_t parent, std::vector<extension_t> & extensions) const;
+
+public:
+	LayoutOptimizer(std::shared_ptr<Level> level, const settings_t & settings);
+
+	//! \brief Returns the best layout found, playing games on all threads of the JobSystem.
+	//! Its score comes from playing it again with its Towers built at the ticks
+	//! it lists. The outcome does not depend on the thread count.
+	candidate_t optimize(JobSystem & jobs, const progress_function_t & progress) const;
+};
+
+#endif // TDF_LAYOUT_OPTIMIZER_HPP
@@ -7,8 +7,8 @@
 #include "Bullet/BulletFactory.hpp"
 #include "Creep/CreepFactory.hpp"
 #include "Creep/CreepQueryService.hpp"
-#include "Decoration.hpp"
 #include "Tower/TowerFactory.hpp"
+#include "JobSystem.hpp"
 #include "Level.hpp"
 
 using json = nlohmann::json;
@@ -18,12 +18,12 @@ NavigationProvider<sf::Vector2i> & LevelInstance::getGoalNavigationProvider()
 	return gridNavigation_;
 }
 
-std::shared_ptr<Tower> LevelInstance::getTowerAt(sf::Vector2i position)
+Handle<Tower> LevelInstance::getTowerAt(sf::Vector2i position) const
 {
 	if (level_->pointLiesOnGrid(position))
 		return towerMap_[position.y * level_->getWidth() + position.x];
 
-	return nullptr;
+	return Handle<Tower>();
 }
 
 InvasionManager::InvasionManager(const json & data)
@@ -146,7 +146,28 @@ int32_t InvasionManager::getWaveNumber() const
 	return currentWave_;
 }
 
-Level::Level(std::istream & source, Game &game) : game_(game)
+void InvasionManager::save(BinaryWriter & writer) const
+{
+	writer.writeUnsigned(waves_.size());
+	for (const auto & wave : waves_)
+		writer.writeTime(wave.startMoment);
+	writer.writeSigned(creepsRemaining_);
+	writer.writeSigned(currentWave_);
+	writer.writeTime(moment_);
+}
+
+void InvasionManager::load(BinaryReader & reader)
+{
+	if (reader.readUnsigned() != waves_.size())
+		throw std::runtime_error("Saved invasion has a different number of waves");
+	for (auto & wave : waves_)
+		wave.startMoment = reader.readTime();
+	creepsRemaining_ = (int32_t)reader.readSigned();
+	currentWave_ = (int32_t)reader.readSigned();
+	moment_ = reader.readTime();
+}
+
+Level::Level(std::istream & source)
 {
 	json levelDescription;
 	source >> levelDescription;
@@ -156,42 +177,68 @@ Level::Level(std::istream & source, Game &game) : game_(game)
 	goal_ = { levelDescription["goal"][0], levelDescription["goal"][1] };
 	startingMoney_ = levelDescription["starting-money"];
 	startingLives_ = levelDescription["starting-lives"];
+	description_ = levelDescription.dump();
 
 	invasionManager_.reset(new InvasionManager(levelDescription));
 }
 
-LevelInstance::LevelInstance(std::shared_ptr<Level> level, Game & game)
+LevelInstance::LevelInstance(std::shared_ptr<Level> level, uint64_t seed)
 	: level_(level)
-	, towerMap_(new std::shared_ptr<Tower>[level->getWidth() * level->getHeight()])
+	, towerMap_(new Handle<Tower>[level->getWidth() * level->getHeight()])
+	, creepQueryService_(creeps_, gridNavigation_, level->getWidth(), level->getHeight())
 	, invasionManager_(level_->cloneInvasionManager())
 	, gridNavigation_(*this, level->getGoal())
 	, gridTowerPlacement_(*this)
 	, wavesRunning_(false)
 	, money_(level->getStartingMoney())
 	, lives_(level->getStartingLives())
-	, game_(game)
+	, listener_(nullptr)
+	, recorder_(nullptr)
+	, jobs_(nullptr)
+	, seed_(seed)
+	, random_(seed)
+	, tick_(0)
+	, bulletsFlying_(0)
+	, creepsStepped_(false)
+{
+	// Bullets in flight only read Creeps, as Towers do while aiming, so both
+	// run at once
+	phases_.add([this]() { aimTowers(dt_); });
+	phases_.add([this]() { flyBullets(0, bulletsFlying_); });
+}
+
+void LevelInstance::cheatAddMoney(int64_t amount)
 {
-	for (auto source : invasionManager_.getSpawnPoints())
-		decorations_.push_back(std::make_shared<CreepSourceDecoration>(sf::Vector2f(source)));
-	decorations_.push_back(std::make_shared<GoalDecoration>(sf::Vector2f(level->getGoal())));
+	money_ += amount;
 
-	for (const auto & decoration : decorations_)
-		renderables_.push_back(decoration);
+	if (recorder_)
+		recorder_->recordMoneyAdded(tick_, amount);
 }
 
-std::shared_ptr<Selectable> LevelInstance::selectAt(sf::Vector2f position)
+void LevelInstance::cheatBuffCreepSpeed(float strength)
 {
-	for (auto & tower : towers_) {
-		if (tower->isHit(position))
-			return tower;
-	}
+	for (uint32_t i = 0; i < creeps_.size(); ++i)
+		creeps_.applyBuff(i, CreepBuff(5.0f, CreepBuff::Type::BUFF_SPEED, strength));
 
-	for (auto & creep : creeps_) {
-		if (creep->isHit(position))
-			return creep;
-	}
+	if (recorder_)
+		recorder_->recordCreepSpeedBuff(tick_, strength);
+}
+
+void LevelInstance::resume()
+{
+	wavesRunning_ = true;
+
+	if (recorder_)
+		recorder_->recordResume(tick_);
+}
+
+void LevelInstance::sendNextWave()
+{
+	wavesRunning_ = true;
+	invasionManager_.sendNextWave();
 
-	return nullptr;
+	if (recorder_)
+		recorder_->recordNextWave(tick_);
 }
 
 bool LevelInstance::createTowerAt(const std::string & name, sf::Vector2i position)
@@ -203,129 +250,256 @@ bool LevelInstance::createTowerAt(const std::string & name, sf::Vector2i positio
 	if (typeInfo.cost > money_)
 		return false;
 	
-	auto tower = typeInfo.construct({ (float)position.x, (float)position.y }, game_);
-
-	towers_.push_back(tower);
-	renderables_.push_back(tower);
+	auto tower = towers_.add(typeInfo.construct({ (float)position.x, (float)position.y }));
 	towerMap_[position.y * level_->getWidth() + position.x] = tower;
 
-	gridNavigation_.update();
-	gridTowerPlacement_.updateTowerRestrictions();
+	gridNavigation_.update(position);
+	gridTowerPlacement_.invalidateTowerRestrictions();
 	money_ -= typeInfo.cost;
 
+	if (listener_)
+		listener_->onTowerCreated(tower);
+	if (recorder_)
+		recorder_->recordTowerCreated(tick_, name, position);
+
 	return true;
 }
 
 void LevelInstance::createCreepAt(const std::string & name, int32_t life, int32_t bounty, sf::Vector2i position)
 {
-	auto creep = CreepFactory().createCreep(name, life, bounty, position, game_);
-	creeps_.push_back(creep);
-	renderables_.push_back(creep);
-}
+	auto creep = CreepFactory().createCreep(creeps_, name, life, bounty, position);
+	gridTowerPlacement_.invalidateCreepRestrictions();
 
-void LevelInstance::registerBullet(std::shared_ptr<Bullet> bullet)
-{
-	bullets_.push_back(bullet);
-	renderables_.push_back(bullet);
+	if (listener_)
+		listener_->onCreepCreated(creep);
 }
 
-// TODO: Move somewhere else?
-template<typename T, typename F>
-static void removeFromVectorIf(std::vector<T> & v, F f)
+void LevelInstance::registerBullet(Bullet && bullet, const std::string & bulletName)
 {
-	auto it = std::remove_if(v.begin(), v.end(), f);
-	v.resize(std::distance(v.begin(), it));
+	auto handle = bullets_.add(std::move(bullet));
+
+	if (listener_)
+		listener_->onBulletCreated(handle, bulletName);
 }
 
-void LevelInstance::sellTower(Tower* tower)
+void LevelInstance::sellTower(Handle<Tower> tower)
 {
-	sf::Vector2f posf = tower->getPosition();
+	const Tower * sold = towers_.find(tower);
+	if (!sold)
+		return;
+
+	sf::Vector2f posf = sold->getPosition();
 	sf::Vector2i pos = { (int)posf.x, (int)posf.y };
-	int cost = tower->getSellCost();
+	int cost = sold->getSellCost();
 
-	removeFromVectorIf(towers_, [&tower](const std::shared_ptr<Tower>& x) { return x.get() == tower; });
-	towerMap_[pos.y * level_->getWidth() + pos.x].reset();
+	towers_.remove(tower);
+	towerMap_[pos.y * level_->getWidth() + pos.x] = Handle<Tower>();
 
-	gridNavigation_.update();
-	gridTowerPlacement_.updateTowerRestrictions();
+	gridNavigation_.update(pos);
+	gridTowerPlacement_.invalidateTowerRestrictions();
 	money_ += cost;
+
+	if (recorder_)
+		recorder_->recordTowerSold(tick_, pos);
 }
 
-void LevelInstance::update(sf::Time dt)
+template<typename F>
+void LevelInstance::parallelFor(size_t count, size_t grain, F f)
 {
-	if (wavesRunning_)
-		invasionManager_.spawn(shared_from_this(), dt);
+	if (jobs_)
+		jobs_->parallelFor(count, grain, f);
+	else
+		f(0, count);
+}
+
+void LevelInstance::aimTowers(sf::Time dt)
+{
+	creepQueryService_.rebuild();
+
+	towersShooting_.resize(towers_.size());
+	parallelFor(towers_.size(), TOWERS_PER_JOB, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			towersShooting_[i] = towers_[i].aim(dt, creepQueryService_);
+	});
+}
 
-	for (auto & decoration : decorations_)
-		decoration->update(dt);
+void LevelInstance::shootTowers()
+{
+	// Towers shoot in their order, so that bullets are created and random
+	// numbers drawn the same as when run serially
+	for (uint32_t i = 0; i < towers_.size(); ++i) {
+		if (towersShooting_[i]) {
+			BulletFactory factory(*this, towers_[i].getPosition());
+			towers_[i].shoot(factory, random_);
+		}
+	}
+}
 
-	CreepVectorQueryService queryService(creeps_);
+void LevelInstance::flyBullets(size_t begin, size_t end)
+{
+	// Only the instance and begin are captured, which std::function keeps without allocating
+	bulletsHitting_.resize(end);
+	parallelFor(end - begin, BULLETS_PER_JOB, [this, begin](size_t first, size_t last) {
+		for (size_t i = begin + first; i < begin + last; ++i)
+			bulletsHitting_[i] = bullets_[(uint32_t)i].fly(dt_);
+	});
+}
 
-	for (auto & tower : towers_) {
-		BulletFactory factory(shared_from_this(), tower->getPosition());
-		tower->update(dt, factory, queryService);
+void LevelInstance::hitBullets()
+{
+	// Damage and buffs are applied in the order of Bullets
+	for (uint32_t i = 0; i < bullets_.size(); ++i) {
+		if (bulletsHitting_[i])
+			bullets_[i].hit();
 	}
+	bullets_.removeIf([&](const Bullet & b) {
+		return !b.isAlive();
+	});
+}
 
-	for (auto & bullet : bullets_)
-		bullet->update(dt);
-	removeFromVectorIf(bullets_, [&](const std::shared_ptr<Bullet> & b) {
-		return !b->isAlive();
+void LevelInstance::updateCreeps(sf::Time dt)
+{
+	creeps_.updateBuffs(dt);
+
+	creepsStepped_ = false;
+	parallelFor(creeps_.size(), CREEPS_PER_JOB, [&](size_t begin, size_t end) {
+		if (creeps_.walk(dt, gridNavigation_, (uint32_t)begin, (uint32_t)end))
+			creepsStepped_.store(true, std::memory_order_relaxed);
 	});
 
-	for (auto & creep : creeps_) {
-		creep->update(dt, gridNavigation_);
-		if (!creep->isAlive())
-			money_ += creep->getBounty();
-		else if (creep->hasReachedGoal())
+	// Bounties and lives are summed serially, in the order of Creeps
+	for (uint32_t i = 0; i < creeps_.size(); ++i) {
+		if (!creeps_.isAlive(i))
+			money_ += creeps_.getBounty(i);
+		else if (creeps_.hasReachedGoal(i))
 			lives_--;
 	}
-	removeFromVectorIf(creeps_, [&](const std::shared_ptr<Creep> & c) {
-		return !c->isAlive() || c->hasReachedGoal();
+	const size_t count = creeps_.size();
+	creeps_.removeIf([&](uint32_t i) {
+		return !creeps_.isAlive(i) || creeps_.hasReachedGoal(i);
 	});
 
+	// Fields taken by Creeps only change when they step, come or go
+	if (creepsStepped_ || creeps_.size() != count)
+		gridTowerPlacement_.invalidateCreepRestrictions();
+}
+
+void LevelInstance::update(sf::Time dt)
+{
+	// Keyframes are taken before the tick, after the player acted on it
+	if (recorder_ && recorder_->needsKeyframe(tick_))
+		recorder_->recordKeyframe(*this);
+
+	if (wavesRunning_)
+		invasionManager_.spawn(shared_from_this(), dt);
+
+	dt_ = dt;
+	bulletsFlying_ = bullets_.size();
+	if (jobs_)
+		jobs_->run(phases_);
+	else {
+		aimTowers(dt);
+		flyBullets(0, bulletsFlying_);
+	}
+
+	// Shooting tells the listener about new Bullets, so it stays on the
+	// calling thread; Bullets shot this tick fly right away
+	shootTowers();
+	flyBullets(bulletsFlying_, bullets_.size());
+
+	hitBullets();
+	updateCreeps(dt);
+
 	if (wavesRunning_)
 		currentTime_ += dt;
 	
-	gridTowerPlacement_.updateCreepRestrictions();
+	++tick_;
 }
 
-void LevelInstance::render(sf::RenderTarget & target)
+void LevelInstance::save(BinaryWriter & writer) const
 {
-	renderBackground(target);
-
-	// Remove all expired weak_ptrs
-	removeFromVectorIf(renderables_, std::mem_fn(&std::weak_ptr<Renderable>::expired));
-	for (auto & renderable : renderables_)
-		renderable.lock()->render(target);
+	writer.writeUnsigned(SNAPSHOT_VERSION);
+	writer.writeSigned(level_->getWidth());
+	writer.writeSigned(level_->getHeight());
+
+	writer.writeFixed(seed_, sizeof(seed_));
+	random_.save(writer);
+	writer.writeUnsigned(tick_);
+	writer.writeTime(currentTime_);
+	writer.writeByte(wavesRunning_);
+	writer.writeSigned(money_);
+	writer.writeSigned(lives_);
+
+	invasionManager_.save(writer);
+	creeps_.save(writer);
+	towers_.save(writer);
+	bullets_.save(writer);
 }
 
-void LevelInstance::renderBackground(sf::RenderTarget & target)
+void LevelInstance::load(BinaryReader & reader)
 {
-	const int32_t width = level_->getWidth();
-	const int32_t height = level_->getHeight();
-
-	sf::RectangleShape rs;
-	rs.setSize({ 1.f, 1.f });
-	rs.setOrigin({ 0.5f, 0.5f });
-	rs.setTexture(&game_.getTexture("Floor"));
-
-	for (int y = -30; y < height+30; y++) {
-		for (int x = -30; x < width+30; x++) {
-			rs.setFillColor(sf::Color(128, 128, 128, 255));
-			rs.setPosition((float)x, (float)y);
-			target.draw(rs);
-		}
+	if (reader.readUnsigned() != SNAPSHOT_VERSION)
+		throw std::runtime_error("Unsupported snapshot version");
+	if (reader.readSigned() != level_->getWidth() || reader.readSigned() != level_->getHeight())
+		throw std::runtime_error("Snapshot was taken on a different level");
+
+	// Everything is read aside first, so that a malformed snapshot leaves the level as it was
+	const uint64_t seed = reader.readFixed(sizeof(seed_));
+	Random random(seed);
+	random.load(reader);
+	const uint64_t tick = reader.readUnsigned();
+	const sf::Time currentTime = reader.readTime();
+	const bool wavesRunning = reader.readByte() != 0;
+	const int64_t money = reader.readSigned();
+	const int64_t lives = reader.readSigned();
+
+	InvasionManager invasionManager(invasionManager_);
+	invasionManager.load(reader);
+
+	CreepStore creeps;
+	creeps.load(reader);
+	for (uint32_t i = 0; i < creeps.size(); ++i) {
+		if (!level_->pointLiesOnGrid(creeps.getWalkFrom(i)) || !level_->pointLiesOnGrid(creeps.getWalkTo(i)))
+			throw std::runtime_error("Snapshot contains a Creep outside of the level");
 	}
 
-	for (int y = 0; y < height; y++) {
-		for (int x = 0; x < width; x++) {
-			if (gridTowerPlacement_.canPlaceTowerHere({ x, y })) {
-				rs.setFillColor(sf::Color(255, 255, 255, 255));
-			} else {
-				rs.setFillColor(sf::Color(255, 128, 128, 255));
-			}
-			rs.setPosition((float)x, (float)y);
-			target.draw(rs);
-		}
+	EntityRegistry<Tower> towers;
+	towers.load(reader, [&creeps](BinaryReader & reader) {
+		return Tower::load(reader, creeps);
+	});
+	EntityRegistry<Bullet> bullets;
+	bullets.load(reader, [this, &creeps](BinaryReader & reader) {
+		Bullet bullet = Bullet::load(reader, creeps, creeps_);
+		BulletFactory::getBulletName(bullet.getTypeId()); // Throws for unknown types
+		return bullet;
+	});
+
+	const int32_t width = level_->getWidth();
+	std::unique_ptr<Handle<Tower>[]> towerMap(new Handle<Tower>[width * level_->getHeight()]);
+	for (uint32_t i = 0; i < towers.size(); ++i) {
+		const sf::Vector2f posf = towers[i].getPosition();
+		const sf::Vector2i pos = { (int)posf.x, (int)posf.y };
+		if (!level_->pointLiesOnGrid(pos) || towerMap[pos.y * width + pos.x])
+			throw std::runtime_error("Snapshot contains a misplaced Tower");
+		towerMap[pos.y * width + pos.x] = towers.handleAt(i);
 	}
+
+	seed_ = seed;
+	random_ = random;
+	tick_ = tick;
+	currentTime_ = currentTime;
+	wavesRunning_ = wavesRunning;
+	money_ = money;
+	lives_ = lives;
+	invasionManager_ = std::move(invasionManager);
+	creeps_ = std::move(creeps);
+	towers_ = std::move(towers);
+	bullets_ = std::move(bullets);
+	towerMap_.swap(towerMap);
+
+	// Everything else is derived from the entities
+	gridNavigation_.update();
+	gridTowerPlacement_.invalidateTowerRestrictions();
+	gridTowerPlacement_.invalidateCreepRestrictions();
+	creepQueryService_.rebuild();
 }
@@ -3,26 +3,30 @@
 #ifndef TDF_LEVEL_HPP
 #define TDF_LEVEL_HPP
 
+#include <atomic>
 #include <cstdint>
 #include <istream>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <json.hpp>
 
 #include <SFML/System.hpp>
-#include <SFML/Graphics.hpp>
 
-#include "Renderable.hpp"
+#include "BinaryStream.hpp"
 #include "Bullet/Bullet.hpp"
-#include "Creep/Creep.hpp"
-#include "Decoration.hpp"
+#include "Creep/CreepStore.hpp"
+#include "Creep/CreepQueryService.hpp"
 #include "Tower/Tower.hpp"
+#include "EntityRegistry.hpp"
+#include "InputLog.hpp"
+#include "JobSystem.hpp"
 #include "LevelServices.hpp"
+#include "Random.hpp"
 
 class Level;
 class LevelInstance;
-class Game;
 
 //! A factory creating Creeps and adding them to the world at appropriate times.
 class InvasionManager
@@ -71,6 +75,13 @@ public:
 	void sendNextWave();
 
 	int32_t getWaveNumber() const;
+
+	//! Saves the progress of the invasion, but not the waves themselves.
+	void save(BinaryWriter & writer) const;
+
+	//! \brief Restores the progress of the invasion.
+	//! The waves have to come from the same Level as the saved ones.
+	void load(BinaryReader & reader);
 };
 
 //! Contains static information about a level.
@@ -82,10 +93,16 @@ private:
 	sf::Vector2i goal_;
 	int64_t startingMoney_;
 	int64_t startingLives_;
-	Game& game_;
+	std::string description_;
 
 public:
-	Level(std::istream & source, Game &game);
+	Level(std::istream & source);
+
+	//! Returns the JSON the Level was read from, in a compact form.
+	const std::string & getDescription() const
+	{
+		return description_;
+	}
 	int32_t getWidth() const
 	{
 		return width_;
@@ -117,20 +134,46 @@ public:
 	}
 };
 
-class Creep;
+//! \brief Receives notifications about entities entering a LevelInstance.
+//! The simulation itself does not know how its entities look like; the
+//! game client implements this interface to attach visuals to them.
+//! Notifications always come from the thread calling LevelInstance::update,
+//! even when parts of the update run on worker threads.
+class LevelInstanceListener
+{
+public:
+	virtual ~LevelInstanceListener() {}
+
+	virtual void onTowerCreated(Handle<Tower> /*tower*/) {}
+	virtual void onCreepCreated(CreepHandle /*creep*/) {}
+	virtual void onBulletCreated(
+		Handle<Bullet> /*bullet*/,
+		const std::string & /*bulletName*/) {}
+};
 
 //! A class responsible for keeping and updating simulation state
 //! of a level and its entities.
 class LevelInstance : public std::enable_shared_from_this<LevelInstance>
 {
 private:
+	//! Changes whenever the layout of saved state changes.
+	static const uint32_t SNAPSHOT_VERSION = 2;
+
+	//! How many Towers aim in a single job of the JobSystem.
+	static const uint32_t TOWERS_PER_JOB = 32;
+
+	//! How many Bullets fly in a single job of the JobSystem.
+	static const uint32_t BULLETS_PER_JOB = 256;
+
+	//! How many Creeps walk in a single job of the JobSystem.
+	static const uint32_t CREEPS_PER_JOB = 2048;
+
 	std::shared_ptr<Level> level_;
-	std::unique_ptr<std::shared_ptr<Tower>[]> towerMap_;
-	std::vector<std::shared_ptr<Bullet>> bullets_;
-	std::vector<std::shared_ptr<Creep>> creeps_;
-	std::vector<std::shared_ptr<Decoration>> decorations_;
-	std::vector<std::shared_ptr<Tower>> towers_;
-	std::vector<std::weak_ptr<Renderable>> renderables_;
+	std::unique_ptr<Handle<Tower>[]> towerMap_;
+	EntityRegistry<Bullet> bullets_;
+	CreepStore creeps_;
+	EntityRegistry<Tower> towers_;
+	CreepGridQueryService creepQueryService_;
 	InvasionManager invasionManager_;
 	GridNavigationProvider gridNavigation_;
 	GridTowerPlacementOracle gridTowerPlacement_;
@@ -138,51 +181,146 @@ private:
 	bool wavesRunning_;
 	int64_t money_;
 	int64_t lives_;
-	Game& game_;
+	LevelInstanceListener * listener_;
+	InputLog * recorder_;
+	JobSystem * jobs_;
+	uint64_t seed_;
+	Random random_;
+	uint64_t tick_;
+
+	//! Which Towers shoot and Bullets hit this tick, one byte each so they can be written in parallel.
+	std::vector<uint8_t> towersShooting_;
+	std::vector<uint8_t> bulletsHitting_;
+
+	//! \brief Phases of update run by the JobSystem, built once and run every
+	//! tick, so that a tick does not allocate. They read the step of the tick
+	//! and how many Bullets were flying before Towers shot from the members below.
+	TaskGraph phases_;
+	sf::Time dt_;
+	size_t bulletsFlying_;
+
+	//! Set by walking Creeps when one of them stepped on to another field.
+	std::atomic<bool> creepsStepped_;
+
+	//! Runs f(begin, end) over [0, count) with the JobSystem, or serially without one.
+	template<typename F>
+	void parallelFor(size_t count, size_t grain, F f);
+
+	//! \brief Phases of update; those which only read shared state run in parallel.
+	//! Phases which create entities run on the thread calling update, as the
+	//! listener expects to be notified there.
+	void aimTowers(sf::Time dt);
+	void shootTowers();
+	void flyBullets(size_t begin, size_t end);
+	void hitBullets();
+	void updateCreeps(sf::Time dt);
 
 public:
-	LevelInstance(std::shared_ptr<Level> level, Game &game);
+	//! Creates an instance whose randomness is determined by the seed.
+	LevelInstance(std::shared_ptr<Level> level, uint64_t seed);
+
+	//! Phases of update refer to the instance, so it stays where it was created.
+	LevelInstance(const LevelInstance &) = delete;
+	LevelInstance & operator=(const LevelInstance &) = delete;
+
 	NavigationProvider<sf::Vector2i> & getGoalNavigationProvider();
 	std::shared_ptr<Level> getLevel() const
 	{
 		return level_;
 	}
-	std::shared_ptr<Tower> getTowerAt(sf::Vector2i position);
-	std::shared_ptr<Tower> getTowerAt(int x, int y)
+	uint64_t getSeed() const
+	{
+		return seed_;
+	}
+
+	//! Returns how many times update was called.
+	uint64_t getTick() const
+	{
+		return tick_;
+	}
+	Handle<Tower> getTowerAt(sf::Vector2i position) const;
+	Handle<Tower> getTowerAt(int x, int y) const
 	{
 		return getTowerAt({ x, y });
 	}
 
+	//! Cheaper alternative of getTowerAt for when the Tower itself is not needed.
+	bool hasTowerAt(int x, int y) const
+	{
+		return level_->pointLiesOnGrid({ x, y })
+			&& towerMap_[y * level_->getWidth() + x];
+	}
+
 	bool canPlaceTowerHere(const sf::Vector2i & at) const
 	{
 		return gridTowerPlacement_.canPlaceTowerHere(at);
 	}
 
-	int64_t getMoney() const
+	//! Returns a number which changes whenever canPlaceTowerHere may change.
+	uint64_t getTowerPlacementVersion() const
 	{
-		return money_;
+		return gridTowerPlacement_.getChangeCount();
 	}
 
-	void cheatAddMoney(int64_t amount)
+	int64_t getMoney() const
 	{
-		money_ += amount;
+		return money_;
 	}
 
+	void cheatAddMoney(int64_t amount);
+
+	//! Applies a short speed buff of given strength to all creeps.
+	void cheatBuffCreepSpeed(float strength);
+
 	int64_t getLives() const
 	{
 		return lives_;
 	}
 
-	void resume()
+	void resume();
+
+	//! Resumes the invasion and starts the next wave right away.
+	void sendNextWave();
+
+	const CreepStore & getCreeps() const
 	{
-		wavesRunning_ = true;
+		return creeps_;
 	}
 
-	const std::vector<std::shared_ptr<Creep>> & getCreeps() const
+	CreepStore & getCreeps()
 	{
 		return creeps_;
 	}
 
+	const EntityRegistry<Tower> & getTowers() const
+	{
+		return towers_;
+	}
+
+	const EntityRegistry<Bullet> & getBullets() const
+	{
+		return bullets_;
+	}
+
+	//! Sets the object notified about created entities, may be null.
+	void setListener(LevelInstanceListener * listener)
+	{
+		listener_ = listener;
+	}
+
+	//! Sets the log to which player actions are recorded, may be null.
+	void setRecorder(InputLog * recorder)
+	{
+		recorder_ = recorder;
+	}
+
+	//! \brief Sets the JobSystem running parts of update in parallel, may be null.
+	//! The outcome does not depend on it, nor on its worker count.
+	void setJobSystem(JobSystem * jobs)
+	{
+		jobs_ = jobs;
+	}
+
 	bool hasWon() const
 	{
 		return creeps_.empty() && invasionManager_.invasionEnded();
@@ -198,9 +336,6 @@ public:
 		return invasionManager_;
 	}
 
-	//! Returns a control widget for an object selected by mouse position.
-	std::shared_ptr<Selectable> selectAt(sf::Vector2f position);
-
 	//! \brief Creates a tower at given position.
 	//! Returns if there was enough cash to instantiate the tower.
 	bool createTowerAt(const std::string & name, sf::Vector2i position);
@@ -208,14 +343,22 @@ public:
 		const std::string & name,
 		int32_t life, int32_t bounty,
 		sf::Vector2i position);
-	void registerBullet(std::shared_ptr<Bullet> bullet);
-	void sellTower(Tower* tower);
+	void registerBullet(Bullet && bullet, const std::string & bulletName);
+
+	//! Sells the Tower, unless it was already sold.
+	void sellTower(Handle<Tower> tower);
 
 	void update(sf::Time dt);
-	void render(sf::RenderTarget & target);
 
-private:
-	void renderBackground(sf::RenderTarget & target);
+	//! \brief Saves the state of the simulation, the Level excluded.
+	//! Saving, loading and continuing plays out the same as not stopping.
+	void save(BinaryWriter & writer) const;
+
+	//! \brief Replaces the state of the simulation with a saved one.
+	//! The Level has to be the same as when saving. The listener is not told
+	//! about loaded entities. Throws std::runtime_error if the saved data is
+	//! malformed or does not fit the Level.
+	void load(BinaryReader & reader);
 };
 
 #endif // TDF_LEVEL_HPP
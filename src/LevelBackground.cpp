@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <cmath>
+#include "LevelBackground.hpp"
+
+const int32_t LevelBackground::MARGIN;
+
+LevelBackground::LevelBackground(const LevelInstance & levelInstance, const sf::Texture * texture)
+	: levelInstance_(levelInstance)
+	, texture_(texture)
+	, tintedTileCount_(0)
+{
+	const int32_t width = levelInstance_.getLevel()->getWidth();
+	const int32_t height = levelInstance_.getLevel()->getHeight();
+
+	tiles_.reserve(width * height * 4);
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++)
+			appendTile(tiles_, x, y);
+	}
+
+	tintedVersion_ = levelInstance_.getTowerPlacementVersion() - 1;
+}
+
+uint32_t LevelBackground::getTileCount() const
+{
+	const int32_t width = levelInstance_.getLevel()->getWidth();
+	const int32_t height = levelInstance_.getLevel()->getHeight();
+	return (width + 2 * MARGIN) * (height + 2 * MARGIN);
+}
+
+void LevelBackground::appendTile(std::vector<sf::Vertex> & vertices, int32_t x, int32_t y) const
+{
+	const sf::Vector2f textureSize = texture_ ? sf::Vector2f(texture_->getSize()) : sf::Vector2f(1.f, 1.f);
+	const sf::Vector2f center((float)x, (float)y);
+	const sf::Color gray(128, 128, 128, 255);
+
+	vertices.push_back(sf::Vertex(center + sf::Vector2f(-0.5f, -0.5f), gray, { 0.f, 0.f }));
+	vertices.push_back(sf::Vertex(center + sf::Vector2f(0.5f, -0.5f), gray, { textureSize.x, 0.f }));
+	vertices.push_back(sf::Vertex(center + sf::Vector2f(0.5f, 0.5f), gray, textureSize));
+	vertices.push_back(sf::Vertex(center + sf::Vector2f(-0.5f, 0.5f), gray, { 0.f, textureSize.y }));
+}
+
+void LevelBackground::tint(const sf::IntRect & tiles)
+{
+	const uint64_t version = levelInstance_.getTowerPlacementVersion();
+	if (version == tintedVersion_ && tiles == tintedTiles_)
+		return;
+	tintedVersion_ = version;
+	tintedTiles_ = tiles;
+	tintedTileCount_ = tiles.width * tiles.height;
+
+	const int32_t width = levelInstance_.getLevel()->getWidth();
+
+	for (int y = tiles.top; y < tiles.top + tiles.height; y++) {
+		for (int x = tiles.left; x < tiles.left + tiles.width; x++) {
+			const sf::Color color = levelInstance_.canPlaceTowerHere({ x, y })
+				? sf::Color(255, 255, 255, 255)
+				: sf::Color(255, 128, 128, 255);
+
+			sf::Vertex * tile = &tiles_[(y * width + x) * 4];
+			if (tile[0].color == color)
+				continue;
+			for (int i = 0; i < 4; i++)
+				tile[i].color = color;
+		}
+	}
+}
+
+void LevelBackground::render(sf::RenderTarget & target, const sf::FloatRect & area)
+{
+	const int32_t width = levelInstance_.getLevel()->getWidth();
+	const int32_t height = levelInstance_.getLevel()->getHeight();
+
+	// Tiles of the grid come from the cache, those of the margin are made up
+	const int32_t left = std::max(-MARGIN, (int32_t)ceil(area.left));
+	const int32_t top = std::max(-MARGIN, (int32_t)ceil(area.top));
+	const int32_t right = std::min(width + MARGIN - 1, (int32_t)floor(area.left + area.width));
+	const int32_t bottom = std::min(height + MARGIN - 1, (int32_t)floor(area.top + area.height));
+
+	const int32_t gridLeft = std::max(0, left), gridRight = std::min(width - 1, right);
+	const int32_t gridTop = std::max(0, top), gridBottom = std::min(height - 1, bottom);
+	tintedTileCount_ = 0;
+	if (gridLeft <= gridRight && gridTop <= gridBottom)
+		tint({ gridLeft, gridTop, gridRight - gridLeft + 1, gridBottom - gridTop + 1 });
+
+	visibleTiles_.clear();
+	for (int32_t y = top; y <= bottom; y++) {
+		for (int32_t x = left; x <= right; x++) {
+			if (levelInstance_.getLevel()->pointLiesOnGrid({ x, y })) {
+				const auto tile = tiles_.begin() + (y * width + x) * 4;
+				visibleTiles_.insert(visibleTiles_.end(), tile, tile + 4);
+			}
+			else
+				appendTile(visibleTiles_, x, y);
+		}
+	}
+
+	if (!visibleTiles_.empty())
+		target.draw(visibleTiles_.data(), visibleTiles_.size(), sf::Quads, texture_);
+}
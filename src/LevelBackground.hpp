@@ -0,0 +1,63 @@
+#pragma once
+
+#ifndef TDF_LEVEL_BACKGROUND_HPP
+#define TDF_LEVEL_BACKGROUND_HPP
+
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+#include "Level.hpp"
+
+//! \brief Draws the floor of a LevelInstance, and a margin around it,
+//! with a single draw call per frame.
+//! Grid tiles are tinted by whether a Tower can be placed on them.
+class LevelBackground
+{
+private:
+	const LevelInstance & levelInstance_;
+	//! Floor texture, tiles are untextured without one.
+	const sf::Texture * texture_;
+
+	//! \brief Quads of floor tiles of the grid, row by row.
+	//! Visible ones are copied to visibleTiles_ every frame, along
+	//! with tiles of the margin around the grid, and drawn in one call.
+	//! Only tiles in tintedTiles_ are tinted for tintedVersion_.
+	std::vector<sf::Vertex> tiles_;
+	std::vector<sf::Vertex> visibleTiles_;
+	uint64_t tintedVersion_;
+	sf::IntRect tintedTiles_;
+	uint32_t tintedTileCount_;
+
+	void appendTile(std::vector<sf::Vertex> & vertices, int32_t x, int32_t y) const;
+	//! \brief Tints the given grid tiles again, if placement restrictions
+	//! have changed or other tiles were tinted last time. Creeps change
+	//! the restrictions every tick, so tiles out of view are left alone.
+	void tint(const sf::IntRect & tiles);
+
+public:
+	//! Tiles drawn around the grid on every side.
+	static const int32_t MARGIN = 30;
+
+	LevelBackground(const LevelInstance & levelInstance, const sf::Texture * texture);
+
+	//! Draws the tiles inside the area, in level coordinates.
+	void render(sf::RenderTarget & target, const sf::FloatRect & area);
+
+	//! Number of tiles drawn by the last render.
+	inline uint32_t getVisibleTileCount() const
+	{
+		return (uint32_t)visibleTiles_.size() / 4;
+	}
+
+	//! Number of tiles tinted again by the last render, 0 if none had to be.
+	inline uint32_t getTintedTileCount() const
+	{
+		return tintedTileCount_;
+	}
+
+	//! Number of tiles of the grid and its margin.
+	uint32_t getTileCount() const;
+};
+
+#endif // TDF_LEVEL_BACKGROUND_HPP
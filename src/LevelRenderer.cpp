@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <cmath>
+#include "Bullet/BulletFactory.hpp"
+#include "Game.hpp"
+#include "LevelRenderer.hpp"
+
+const int32_t LevelRenderer::BLOCK_SIZE;
+
+template<typename T>
+static void removeExpired(std::vector<std::shared_ptr<T>> & views)
+{
+	auto it = std::remove_if(views.begin(), views.end(),
+		[](const std::shared_ptr<T> & view) { return view->isExpired(); });
+	views.erase(it, views.end());
+}
+
+LevelRenderer::LevelRenderer(LevelInstance & levelInstance, Game & game)
+	: levelInstance_(levelInstance)
+	, game_(game)
+	, towerAt_(new TowerView*[levelInstance.getLevel()->getWidth() * levelInstance.getLevel()->getHeight()])
+	, background_(levelInstance, &game.getTexture("Floor"))
+	, blockColumns_((levelInstance.getLevel()->getWidth() + BLOCK_SIZE - 1) / BLOCK_SIZE)
+	, blockRows_((levelInstance.getLevel()->getHeight() + BLOCK_SIZE - 1) / BLOCK_SIZE)
+	, blocksOutdated_(true)
+	, stats_()
+{
+	const int32_t tableSize = levelInstance.getLevel()->getWidth() * levelInstance.getLevel()->getHeight();
+	std::fill(towerAt_.get(), towerAt_.get() + tableSize, nullptr);
+
+	for (auto source : levelInstance_.getInvasionManager().getSpawnPoints())
+		decorations_.push_back(std::make_shared<CreepSourceDecoration>(sf::Vector2f(source)));
+	decorations_.push_back(std::make_shared<GoalDecoration>(sf::Vector2f(levelInstance_.getLevel()->getGoal())));
+
+	// A LevelInstance loaded from a saved game already has entities
+	const auto & towers = levelInstance_.getTowers();
+	for (uint32_t i = 0; i < towers.size(); ++i)
+		onTowerCreated(towers.handleAt(i));
+	const auto & creeps = levelInstance_.getCreeps();
+	for (uint32_t i = 0; i < creeps.size(); ++i)
+		onCreepCreated(creeps.handleAt(i));
+	const auto & bullets = levelInstance_.getBullets();
+	for (uint32_t i = 0; i < bullets.size(); ++i)
+		onBulletCreated(bullets.handleAt(i), BulletFactory::getBulletName(bullets[i].getTypeId()));
+
+	levelInstance_.setListener(this);
+}
+
+LevelRenderer::~LevelRenderer()
+{
+	levelInstance_.setListener(nullptr);
+}
+
+void LevelRenderer::removeExpiredViews()
+{
+	// A Tower built where a sold one stood may already have its view there
+	const int32_t width = levelInstance_.getLevel()->getWidth();
+	for (const auto & tower : towers_) {
+		if (tower->isExpired()) {
+			const auto position = tower->getPosition();
+			TowerView *& at = towerAt_[(int32_t)position.y * width + (int32_t)position.x];
+			if (at == tower.get())
+				at = nullptr;
+		}
+	}
+
+	const size_t creepCount = creeps_.size(), bulletCount = bullets_.size();
+	removeExpired(towers_);
+	removeExpired(creeps_);
+	removeExpired(bullets_);
+	if (creeps_.size() != creepCount || bullets_.size() != bulletCount)
+		blocksOutdated_ = true;
+}
+
+template<typename F>
+void LevelRenderer::sortIntoBlocks(viewBlocks_t & blocks, size_t count, F boundsOf)
+{
+	// Counting sort by block, as CreepGridQueryService does by field
+	blocks.start.assign(blockColumns_ * blockRows_ + 1, 0);
+	blocks.indices.resize(count);
+	blocks.blockOf.resize(count);
+	blocks.reach = 0.f;
+
+	for (size_t i = 0; i < count; ++i) {
+		const sf::FloatRect bounds = boundsOf(i);
+		const float x = bounds.left + 0.5f * bounds.width;
+		const float y = bounds.top + 0.5f * bounds.height;
+		const int32_t column = std::max(0, std::min(blockColumns_ - 1, (int32_t)floor((x + 0.5f) / BLOCK_SIZE)));
+		const int32_t row = std::max(0, std::min(blockRows_ - 1, (int32_t)floor((y + 0.5f) / BLOCK_SIZE)));
+		blocks.blockOf[i] = row * blockColumns_ + column;
+		blocks.reach = std::max(blocks.reach, 0.5f * std::max(bounds.width, bounds.height));
+		++blocks.start[blocks.blockOf[i] + 1];
+	}
+
+	for (size_t i = 1; i < blocks.start.size(); ++i)
+		blocks.start[i] += blocks.start[i - 1];
+	for (size_t i = 0; i < count; ++i)
+		blocks.indices[blocks.start[blocks.blockOf[i]]++] = (uint32_t)i;
+	for (size_t i = blocks.start.size() - 1; i > 0; --i)
+		blocks.start[i] = blocks.start[i - 1];
+	blocks.start[0] = 0;
+}
+
+const std::vector<uint32_t> & LevelRenderer::findViewsNear(const viewBlocks_t & blocks, const sf::FloatRect & area)
+{
+	// Views sorted into edge blocks may lie beyond the level, so ranges are clamped
+	auto blockAt = [](float v, int32_t count) {
+		return std::max(0, std::min(count - 1, (int32_t)floor((v + 0.5f) / BLOCK_SIZE)));
+	};
+	const int32_t left = blockAt(area.left - blocks.reach, blockColumns_);
+	const int32_t right = blockAt(area.left + area.width + blocks.reach, blockColumns_);
+	const int32_t top = blockAt(area.top - blocks.reach, blockRows_);
+	const int32_t bottom = blockAt(area.top + area.height + blocks.reach, blockRows_);
+
+	nearbyViews_.clear();
+	for (int32_t row = top; row <= bottom; ++row) {
+		for (int32_t column = left; column <= right; ++column) {
+			const int32_t block = row * blockColumns_ + column;
+			nearbyViews_.insert(nearbyViews_.end(),
+				blocks.indices.begin() + blocks.start[block], blocks.indices.begin() + blocks.start[block + 1]);
+		}
+	}
+
+	// Views are drawn in the order they were created in, as without culling
+	std::sort(nearbyViews_.begin(), nearbyViews_.end());
+	return nearbyViews_;
+}
+
+std::shared_ptr<Selectable> LevelRenderer::selectAt(sf::Vector2f position)
+{
+	removeExpiredViews();
+
+	for (auto & tower : towers_) {
+		if (tower->isHit(position))
+			return tower;
+	}
+
+	for (auto & creep : creeps_) {
+		if (creep->isHit(position))
+			return creep;
+	}
+
+	return nullptr;
+}
+
+void LevelRenderer::update(sf::Time dt)
+{
+	removeExpiredViews();
+	blocksOutdated_ = true;
+
+	for (auto & decoration : decorations_)
+		decoration->update(dt);
+	for (auto & tower : towers_)
+		tower->update(dt);
+	for (auto & creep : creeps_)
+		creep->update(dt);
+	for (auto & bullet : bullets_)
+		bullet->update(dt);
+}
+
+void LevelRenderer::render(sf::RenderTarget & target, float interpolation)
+{
+	removeExpiredViews();
+
+	// Anything may stick out of its field by less than a field
+	const sf::View & view = target.getView();
+	const sf::Vector2f size = view.getSize() + sf::Vector2f(2.f, 2.f);
+	const sf::FloatRect area(view.getCenter() - 0.5f * size, size);
+
+	background_.render(target, area);
+	stats_.visibleTiles = background_.getVisibleTileCount();
+	stats_.culledTiles = background_.getTileCount() - stats_.visibleTiles;
+
+	// Decorations go in a batch of their own to stay below entities
+	for (auto & decoration : decorations_)
+		decoration->render(batch_);
+	batch_.draw(target);
+
+	const int32_t width = levelInstance_.getLevel()->getWidth();
+	const int32_t height = levelInstance_.getLevel()->getHeight();
+	const int32_t left = std::max(0, (int32_t)ceil(area.left));
+	const int32_t top = std::max(0, (int32_t)ceil(area.top));
+	const int32_t right = std::min(width - 1, (int32_t)floor(area.left + area.width));
+	const int32_t bottom = std::min(height - 1, (int32_t)floor(area.top + area.height));
+
+	uint32_t visible = 0;
+	for (int32_t y = top; y <= bottom; y++) {
+		for (int32_t x = left; x <= right; x++) {
+			if (TowerView * tower = towerAt_[y * width + x]) {
+				tower->render(batch_);
+				visible++;
+			}
+		}
+	}
+
+	// A Creep is drawn less than a field away from where it was after the last tick
+	if (blocksOutdated_) {
+		sortIntoBlocks(creepBlocks_, creeps_.size(), [this](size_t i) {
+			return sf::FloatRect(creeps_[i]->getPosition(1.f) - sf::Vector2f(1.f, 1.f), { 2.f, 2.f });
+		});
+		sortIntoBlocks(bulletBlocks_, bullets_.size(), [this](size_t i) {
+			return bullets_[i]->getBounds();
+		});
+		blocksOutdated_ = false;
+	}
+
+	for (uint32_t i : findViewsNear(creepBlocks_, area)) {
+		if (area.contains(creeps_[i]->getPosition(interpolation))) {
+			creeps_[i]->render(batch_, interpolation);
+			visible++;
+		}
+	}
+
+	for (uint32_t i : findViewsNear(bulletBlocks_, area)) {
+		if (area.intersects(bullets_[i]->getBounds())) {
+			bullets_[i]->render(batch_, interpolation);
+			visible++;
+		}
+	}
+
+	batch_.draw(target);
+
+	stats_.visibleEntities = visible;
+	stats_.culledEntities = (uint32_t)(towers_.size() + creeps_.size() + bullets_.size()) - visible;
+}
+
+void LevelRenderer::onTowerCreated(Handle<Tower> tower)
+{
+	auto view = std::make_shared<TowerView>(
+		levelInstance_.getTowers(), tower, levelInstance_.getCreeps(), game_);
+	const auto position = view->getPosition();
+	towerAt_[(int32_t)position.y * levelInstance_.getLevel()->getWidth() + (int32_t)position.x] = view.get();
+	towers_.push_back(view);
+}
+
+void LevelRenderer::onCreepCreated(CreepHandle creep)
+{
+	creeps_.push_back(std::make_shared<CreepView>(levelInstance_.getCreeps(), creep, game_));
+	blocksOutdated_ = true;
+}
+
+void LevelRenderer::onBulletCreated(Handle<Bullet> bullet, const std::string & bulletName)
+{
+	bullets_.push_back(std::make_shared<BulletView>(levelInstance_.getBullets(), bullet, bulletName));
+	blocksOutdated_ = true;
+}
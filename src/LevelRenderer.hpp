@@ -0,0 +1,105 @@
+#pragma once
+
+#ifndef TDF_LEVEL_RENDERER_HPP
+#define TDF_LEVEL_RENDERER_HPP
+
+#include <memory>
+#include <vector>
+
+#include <SFML/System.hpp>
+#include <SFML/Graphics.hpp>
+
+#include "Level.hpp"
+#include "LevelBackground.hpp"
+#include "Decoration.hpp"
+#include "Selectable.hpp"
+#include "SpriteBatch.hpp"
+#include "Bullet/BulletView.hpp"
+#include "Creep/CreepView.hpp"
+#include "Tower/TowerView.hpp"
+
+class Game;
+
+//! \brief Draws a LevelInstance.
+//! Listens for entities created by the simulation and keeps a view
+//! for each of them, as long as the entity stays in the level.
+class LevelRenderer final : public LevelInstanceListener
+{
+public:
+	//! Numbers of things drawn and skipped in the last frame.
+	struct cullingStats_t
+	{
+		uint32_t visibleTiles, culledTiles;
+		uint32_t visibleEntities, culledEntities;
+	};
+
+private:
+	//! Creeps and Bullets are sorted into square blocks of this many fields a side.
+	static const int32_t BLOCK_SIZE = 8;
+
+	//! \brief Indices of views sorted by the block of the level they are in,
+	//! so that drawing only visits blocks overlapping the view.
+	struct viewBlocks_t
+	{
+		//! Views of block i are indices[start[i]] .. indices[start[i + 1] - 1].
+		std::vector<uint32_t> start;
+		std::vector<uint32_t> indices;
+		std::vector<int32_t> blockOf;
+		//! How far from the center of its bounds any of the views reaches.
+		float reach;
+	};
+
+	LevelInstance & levelInstance_;
+	Game & game_;
+	std::vector<std::shared_ptr<Decoration>> decorations_;
+	std::vector<std::shared_ptr<TowerView>> towers_;
+	std::vector<std::shared_ptr<CreepView>> creeps_;
+	std::vector<std::shared_ptr<BulletView>> bullets_;
+	//! View of the Tower standing on each field of the grid, if any.
+	std::unique_ptr<TowerView*[]> towerAt_;
+
+	LevelBackground background_;
+
+	int32_t blockColumns_, blockRows_;
+	viewBlocks_t creepBlocks_, bulletBlocks_;
+	//! Set when views were added, removed or moved since they were sorted into blocks.
+	bool blocksOutdated_;
+	std::vector<uint32_t> nearbyViews_;
+	SpriteBatch batch_;
+	cullingStats_t stats_;
+
+	//! Drops views of entities which are no longer in the level.
+	void removeExpiredViews();
+	//! Sorts count views into blocks, by the center of boundsOf(index).
+	template<typename F>
+	void sortIntoBlocks(viewBlocks_t & blocks, size_t count, F boundsOf);
+	//! Returns indices of views in blocks near the area, in ascending order.
+	const std::vector<uint32_t> & findViewsNear(const viewBlocks_t & blocks, const sf::FloatRect & area);
+
+public:
+	LevelRenderer(LevelInstance & levelInstance, Game & game);
+	virtual ~LevelRenderer();
+
+	//! Returns an object selected by mouse position.
+	std::shared_ptr<Selectable> selectAt(sf::Vector2f position);
+
+	//! Advances animations, called after every tick of the simulation.
+	void update(sf::Time dt);
+	//! \brief Draws what lies inside the view of the target.
+	//! Moving entities are drawn between their positions after the last
+	//! two ticks, interpolation being the fraction of a tick past the last.
+	void render(sf::RenderTarget & target, float interpolation);
+
+	inline const cullingStats_t & getCullingStats() const
+	{
+		return stats_;
+	}
+
+	virtual void onTowerCreated(Handle<Tower> tower) override;
+	virtual void onCreepCreated(CreepHandle creep) override;
+	virtual void onBulletCreated(
+		Handle<Bullet> bullet,
+		const std::string & bulletName) override;
+};
+
+#endif // TDF_LEVEL_RENDERER_HPP
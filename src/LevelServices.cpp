@@ -1,7 +1,15 @@
+#include <cassert>
+#include <functional>
 #include <queue>
+#include <utility>
+#include <vector>
 #include "Level.hpp"
 #include "LevelServices.hpp"
 
+const int32_t GridNavigationProvider::EMPTY;
+const int32_t GridNavigationProvider::FILLED;
+const int32_t GridNavigationProvider::UNREACHABLE;
+
 GridNavigationProvider::GridNavigationProvider(
 	LevelInstance & levelInstance,
 	sf::Vector2i goal)
@@ -11,6 +19,9 @@ GridNavigationProvider::GridNavigationProvider(
 	const auto & level = levelInstance.getLevel();
 	const int32_t tableSize = level->getWidth() * level->getHeight();
 	path_ = std::unique_ptr<int32_t[]>(new int32_t[tableSize]);
+	distance_ = std::unique_ptr<int32_t[]>(new int32_t[tableSize]);
+	affected_ = std::unique_ptr<bool[]>(new bool[tableSize]);
+	std::fill(affected_.get(), affected_.get() + tableSize, false);
 
 	// Calculate paths for the first time
 	update();
@@ -32,11 +43,55 @@ sf::Vector2i GridNavigationProvider::getNextStep(const sf::Vector2i & point) con
 	return{ toIndex % width, toIndex / width };
 }
 
+int32_t GridNavigationProvider::getDistanceToGoal(const sf::Vector2i & point) const
+{
+	assert(levelInstance_.getLevel()->pointLiesOnGrid(point));
+
+	return distance_[point.y * levelInstance_.getLevel()->getWidth() + point.x];
+}
+
+template<typename F>
+void GridNavigationProvider::forEachNeighbour(int32_t index, F f) const
+{
+	const int32_t width = levelInstance_.getLevel()->getWidth();
+	const int32_t height = levelInstance_.getLevel()->getHeight();
+	const int32_t x = index % width;
+	const int32_t y = index / width;
+
+	if (y < height - 1)
+		f(index + width);
+	if (y > 0)
+		f(index - width);
+	if (x < width - 1)
+		f(index + 1);
+	if (x > 0)
+		f(index - 1);
+}
+
+void GridNavigationProvider::choosePath(int32_t index)
+{
+	if (path_[index] == FILLED)
+		return;
+
+	if (distance_[index] == 0) {
+		path_[index] = index;
+		return;
+	}
+
+	int32_t best = EMPTY;
+	if (distance_[index] != UNREACHABLE) {
+		forEachNeighbour(index, [&](int32_t next) {
+			if (best == EMPTY && distance_[next] == distance_[index] - 1)
+				best = next;
+		});
+	}
+	path_[index] = best;
+}
+
 void GridNavigationProvider::update()
 {
-	// A simple BFS algorithm creating BFS-tree.
-	// For small maps it should suffice.
-	static const int32_t EMPTY = -1, FILLED = -2;
+	// A BFS from the goal calculates distances, then every cell
+	// chooses its path by looking at its neighbours.
 	const int32_t width = levelInstance_.getLevel()->getWidth();
 	const int32_t height = levelInstance_.getLevel()->getHeight();
 	const int32_t tableSize = width * height;
@@ -44,15 +99,15 @@ void GridNavigationProvider::update()
 
 	// Prepare tables
 	std::fill(path_.get(), path_.get() + tableSize, EMPTY);
+	std::fill(distance_.get(), distance_.get() + tableSize, UNREACHABLE);
 	const int32_t goalIndex = goal_.y * width + goal_.x;
 	verts.emplace(goalIndex);
-
-	path_[goalIndex] = goalIndex;
+	distance_[goalIndex] = 0;
 
 	// Reserve locations occupied by towers
 	for (int y = 0; y < height; y++) {
 		for (int x = 0; x < width; x++) {
-			if (levelInstance_.getTowerAt({ x, y })) {
+			if (levelInstance_.hasTowerAt(x, y)) {
 				path_[y * width + x] = FILLED;
 			}
 		}
@@ -63,44 +118,162 @@ void GridNavigationProvider::update()
 		const int32_t current = verts.front();
 		verts.pop();
 
-		const int32_t x = current % width;
-		const int32_t y = current / width;
-
-		auto tryPushVertex = [&](int32_t next)
-		{
-			if (path_[next] == EMPTY) {
-				path_[next] = current;
+		forEachNeighbour(current, [&](int32_t next) {
+			if (path_[next] != FILLED && distance_[next] == UNREACHABLE) {
+				distance_[next] = distance_[current] + 1;
 				verts.emplace(next);
 			}
-		};
-
-		if (y < height - 1)
-			tryPushVertex(current + width);
-		if (y > 0)
-			tryPushVertex(current - width);
-		if (x < width - 1)
-			tryPushVertex(current + 1);
-		if (x > 0)
-			tryPushVertex(current - 1);
+		});
 
 	} while (!verts.empty());
+
+	for (int32_t i = 0; i < tableSize; ++i)
+		choosePath(i);
+}
+
+void GridNavigationProvider::update(sf::Vector2i changed)
+{
+	const int32_t width = levelInstance_.getLevel()->getWidth();
+	const int32_t index = changed.y * width + changed.x;
+	const bool blocked = levelInstance_.hasTowerAt(changed.x, changed.y);
+
+	if (changed == goal_) {
+		update();
+		return;
+	}
+
+	if (blocked && path_[index] != FILLED)
+		block(index);
+	else if (!blocked && path_[index] == FILLED)
+		unblock(index);
+}
+
+void GridNavigationProvider::block(int32_t index)
+{
+	path_[index] = FILLED;
+
+	// Find cells which lose all their shortest paths. Only descendants of
+	// the blocked cell can, and they are visited in order of distance, so
+	// every closer cell has already been classified when a cell is checked.
+	region_.clear();
+	region_.push_back(index);
+	affected_[index] = true;
+
+	for (size_t i = 0; i < region_.size(); ++i) {
+		const int32_t current = region_[i];
+		forEachNeighbour(current, [&](int32_t child) {
+			if (path_[child] != current || affected_[child])
+				return;
+
+			bool keepsDistance = false;
+			forEachNeighbour(child, [&](int32_t other) {
+				if (!affected_[other] && path_[other] != FILLED
+					&& distance_[other] == distance_[child] - 1)
+					keepsDistance = true;
+			});
+
+			if (!keepsDistance) {
+				affected_[child] = true;
+				region_.push_back(child);
+			}
+		});
+	}
+
+	for (auto current : region_)
+		distance_[current] = UNREACHABLE;
+
+	// Affected cells are reached again from their unaffected neighbours
+	typedef std::pair<int32_t, int32_t> entry_t;
+	std::priority_queue<entry_t, std::vector<entry_t>, std::greater<entry_t>> verts;
+
+	for (size_t i = 1; i < region_.size(); ++i) {
+		const int32_t current = region_[i];
+		forEachNeighbour(current, [&](int32_t next) {
+			if (!affected_[next] && path_[next] != FILLED && distance_[next] != UNREACHABLE)
+				distance_[current] = std::min(distance_[current], distance_[next] + 1);
+		});
+		if (distance_[current] != UNREACHABLE)
+			verts.emplace(distance_[current], current);
+	}
+
+	while (!verts.empty()) {
+		const auto top = verts.top();
+		verts.pop();
+		if (top.first != distance_[top.second])
+			continue;
+
+		forEachNeighbour(top.second, [&](int32_t next) {
+			if (affected_[next] && next != index && top.first + 1 < distance_[next]) {
+				distance_[next] = top.first + 1;
+				verts.emplace(distance_[next], next);
+			}
+		});
+	}
+
+	for (auto current : region_) {
+		affected_[current] = false;
+		choosePath(current);
+		forEachNeighbour(current, [&](int32_t next) { choosePath(next); });
+	}
+}
+
+void GridNavigationProvider::unblock(int32_t index)
+{
+	path_[index] = EMPTY;
+	distance_[index] = UNREACHABLE;
+	forEachNeighbour(index, [&](int32_t next) {
+		if (path_[next] != FILLED && distance_[next] != UNREACHABLE)
+			distance_[index] = std::min(distance_[index], distance_[next] + 1);
+	});
+
+	// Distances can only get shorter, and only through the freed cell
+	region_.clear();
+	if (distance_[index] != UNREACHABLE)
+		region_.push_back(index);
+
+	for (size_t i = 0; i < region_.size(); ++i) {
+		const int32_t current = region_[i];
+		forEachNeighbour(current, [&](int32_t next) {
+			if (path_[next] != FILLED && distance_[current] + 1 < distance_[next]) {
+				distance_[next] = distance_[current] + 1;
+				region_.push_back(next);
+			}
+		});
+	}
+
+	choosePath(index);
+	for (auto current : region_) {
+		choosePath(current);
+		forEachNeighbour(current, [&](int32_t next) { choosePath(next); });
+	}
 }
 
+const int32_t GridTowerPlacementOracle::EMPTY;
+const int32_t GridTowerPlacementOracle::ROOT;
+
 GridTowerPlacementOracle::GridTowerPlacementOracle(LevelInstance & levelInstance)
 	: levelInstance_(levelInstance)
+	, towersChanged_(true)
+	, creepsChanged_(true)
+	, changes_(0)
+	, tick_(0)
 {
 	auto level = levelInstance.getLevel();
 	const int32_t tableSize = level->getWidth() * level->getHeight();
 	permanentlyOccupied_.reset(new bool[tableSize]);
-	validTurretPlaces_.reset(new bool[tableSize]);
 	occupiedByCreeps_.reset(new bool[tableSize]);
+	occupiedAt_.reset(new uint32_t[tableSize]);
 	parents_.reset(new int32_t[tableSize]);
 	pre_.reset(new int32_t[tableSize]);
 	low_.reset(new int32_t[tableSize]);
-	dp_.reset(new int32_t[tableSize]);
+	end_.reset(new int32_t[tableSize]);
+	required_.reset(new int32_t[tableSize + 1]);
+	stack_.reset(new frame_t[tableSize]);
 
 	const int32_t width = levelInstance_.getLevel()->getWidth();
 	std::fill(permanentlyOccupied_.get(), permanentlyOccupied_.get() + tableSize, false);
+	std::fill(occupiedByCreeps_.get(), occupiedByCreeps_.get() + tableSize, false);
+	std::fill(occupiedAt_.get(), occupiedAt_.get() + tableSize, 0);
 
 	// Forbid placing on goals, as it may be a non-cut point
 	const auto goal = levelInstance_.getLevel()->getGoal();
@@ -110,131 +283,186 @@ GridTowerPlacementOracle::GridTowerPlacementOracle(LevelInstance & levelInstance
 	// Forbid placing on spawn points
 	for (const auto & spawnPoint : levelInstance_.getInvasionManager().getSpawnPoints())
 		permanentlyOccupied_[spawnPoint.y * width + spawnPoint.x] = true;
-
-	updateTowerRestrictions();
-	updateCreepRestrictions();
 }
 
 bool GridTowerPlacementOracle::canPlaceTowerHere(const sf::Vector2i & at) const
 {
-	const auto width = levelInstance_.getLevel()->getWidth();
+	const int32_t width = levelInstance_.getLevel()->getWidth();
+	const int32_t height = levelInstance_.getLevel()->getHeight();
 
-	if (levelInstance_.getLevel()->pointLiesOnGrid(at)) {
-		const auto index = at.y * width + at.x;
-		return !permanentlyOccupied_[index] && validTurretPlaces_[index] && !occupiedByCreeps_[index];
+	if (!levelInstance_.getLevel()->pointLiesOnGrid(at))
+		return false;
+
+	// Creeps go first, so that a new dfs tree counts them right away
+	if (creepsChanged_) {
+		updateCreepRestrictions();
+		creepsChanged_ = false;
+	}
+	if (towersChanged_) {
+		updateTowerRestrictions();
+		towersChanged_ = false;
 	}
 
-	return false;
+	const int32_t current = at.y * width + at.x;
+	if (permanentlyOccupied_[current] || occupiedByCreeps_[current]
+		|| levelInstance_.hasTowerAt(at.x, at.y))
+		return false;
+
+	// A tower here must not cut any occupied cell off the goal.
+	// Note we don't process root differently, as it never is a valid place
+	// for a turret
+	auto cutsOff = [&](int32_t child) {
+		return parents_[child] == current
+			&& low_[child] >= pre_[current]
+			&& countRequired(pre_[child], end_[child]) > 0;
+	};
+
+	if (at.y < height - 1 && cutsOff(current + width))
+		return false;
+	if (at.y > 0 && cutsOff(current - width))
+		return false;
+	if (at.x < width - 1 && cutsOff(current + 1))
+		return false;
+	if (at.x > 0 && cutsOff(current - 1))
+		return false;
+
+	return true;
+}
+
+void GridTowerPlacementOracle::addRequired(int32_t index, int32_t delta) const
+{
+	// A pending dfs counts all fields from scratch
+	if (towersChanged_ || parents_[index] == EMPTY)
+		return;
+
+	for (int32_t i = pre_[index] + 1; i <= reached_; i += i & -i)
+		required_[i] += delta;
 }
 
-void GridTowerPlacementOracle::updateTowerRestrictions()
+int32_t GridTowerPlacementOracle::countRequired(int32_t begin, int32_t end) const
 {
-	// The algorithm marks cut points, creep sources and the goal
-	// as unsuitable to place a tower on. Every other point is marked as
-	// suitable. It uses program-stack based dfs, so on big maps there
-	// might be a stack overflow.
+	int32_t count = 0;
+	for (int32_t i = end; i > 0; i -= i & -i)
+		count += required_[i];
+	for (int32_t i = begin; i > 0; i -= i & -i)
+		count -= required_[i];
+	return count;
+}
+
+void GridTowerPlacementOracle::updateTowerRestrictions() const
+{
+	// The algorithm finds cut points, creep sources and the goal,
+	// which are unsuitable to place a tower on. The dfs keeps its own
+	// stack of preallocated frames, so it neither recurses nor allocates,
+	// however big the map is. Its result depends only on Towers;
+	// Creeps are accounted for in canPlaceTowerHere.
 	// TODO: This algorithm marks invalid points too eagerly, as some
 	// cut points are still valid turret placement points
 	// (e.g. dead-end corridors leading neither to a source nor the goal).
-	static const int32_t EMPTY = -1;
-	static const int32_t ROOT = -2;
 	const int32_t width = levelInstance_.getLevel()->getWidth();
 	const int32_t height = levelInstance_.getLevel()->getHeight();
 	const int32_t tableSize = width * height;
 	int32_t preCounter = 0;
+	int32_t depth = 0;
 	
 	// First, calculate low and pre numbers
 	std::fill(parents_.get(), parents_.get() + tableSize, EMPTY);
 
-	std::function<void(int32_t, int32_t, int32_t, int32_t)> dfs =
-		[&](int32_t current, int32_t x, int32_t y, int32_t parent) {
-
-		int32_t minimum = preCounter++;
-		pre_[current] = minimum;
+	auto enter = [&](int32_t current, int32_t parent) {
+		pre_[current] = low_[current] = preCounter++;
 		parents_[current] = parent;
-		dp_[current] = permanentlyOccupied_[current] || occupiedByCreeps_[current];
-
-		auto processChild = [&](int32_t child, int32_t nx, int32_t ny) {
-			if (child != parent && !levelInstance_.getTowerAt(nx, ny)) {
-				int32_t v;
-				if (parents_[child] == EMPTY) {
-					dfs(child, nx, ny, current);
-					dp_[current] += dp_[child];
-					v = low_[child];
-				}
-				else
-					v = pre_[child];
-				minimum = std::min(minimum, v);
-			}
+		stack_[depth++] = { current, 0 };
+	};
 
-		};
+	const auto goal = levelInstance_.getLevel()->getGoal();
+	enter(goal.y * width + goal.x, ROOT);
 
-		if (y < height - 1)
-			processChild(current + width, x, y + 1);
-		if (y > 0)
-			processChild(current - width, x, y - 1);
-		if (x < width - 1)
-			processChild(current + 1, x + 1, y);
-		if (x > 0)
-			processChild(current - 1, x - 1, y);
+	while (depth > 0) {
+		frame_t & frame = stack_[depth - 1];
+		const int32_t current = frame.cell;
+		const int32_t x = current % width;
+		const int32_t y = current / width;
 
-		low_[current] = minimum;
-	};
+		// Visit neighbours below, above, to the right and to the left
+		int32_t child = EMPTY;
+		switch (frame.direction++) {
+		case 0: if (y < height - 1) child = current + width; break;
+		case 1: if (y > 0) child = current - width; break;
+		case 2: if (x < width - 1) child = current + 1; break;
+		case 3: if (x > 0) child = current - 1; break;
+		default:
+			// All neighbours done, report to the parent
+			--depth;
+			end_[current] = preCounter;
+			const int32_t parent = parents_[current];
+			if (parent != ROOT)
+				low_[parent] = std::min(low_[parent], low_[current]);
+			continue;
+		}
 
-	const auto goal = levelInstance_.getLevel()->getGoal();
-	const auto goalIndex = goal.y * width + goal.x;
-	dfs(goalIndex, goal.x, goal.y, ROOT);
+		if (child == EMPTY || child == parents_[current]
+			|| levelInstance_.hasTowerAt(child % width, child / width))
+			continue;
 
-	// Now see which vertices are cut points.
-	// Note we don't process root differently, as it never is a valid place
-	// for a turret
-	for (int y = 0; y < height; y++) {
-		for (int x = 0; x < width; x++) {
-			const int32_t current = y * width + x;
+		if (parents_[child] == EMPTY)
+			enter(child, current);
+		else
+			low_[current] = std::min(low_[current], pre_[child]);
+	}
 
-			if (levelInstance_.getTowerAt({ x, y })) {
-				validTurretPlaces_[current] = false;
-				continue;
-			}
+	// Now count occupied cells by pre number, so that any subtree
+	// of the dfs can tell if it holds one
+	reached_ = preCounter;
+	std::fill(required_.get(), required_.get() + reached_ + 1, 0);
+	for (int32_t current = 0; current < tableSize; current++) {
+		if (parents_[current] != EMPTY && (permanentlyOccupied_[current] || occupiedByCreeps_[current]))
+			required_[pre_[current] + 1]++;
+	}
 
-			auto checkChild = [&](int32_t child) {
-				if (parents_[child] == current) {
-					const auto low = low_[child];
-					const auto pre = pre_[current];
-					const auto dp = dp_[child];
-					if ((low >= pre) && (dp > 0)) 
-						validTurretPlaces_[current] = false;
-				}
-			};
-
-			validTurretPlaces_[current] = true;
-
-			if (y < height - 1)
-				checkChild(current + width);
-			if (y > 0)
-				checkChild(current - width);
-			if (x < width - 1)
-				checkChild(current + 1);
-			if (x > 0)
-				checkChild(current - 1);
-		}
+	for (int32_t i = 1; i <= reached_; i++) {
+		const int32_t next = i + (i & -i);
+		if (next <= reached_)
+			required_[next] += required_[i];
 	}
 }
 
-void GridTowerPlacementOracle::updateCreepRestrictions()
+void GridTowerPlacementOracle::updateCreepRestrictions() const
 {
 	const int32_t width = levelInstance_.getLevel()->getWidth();
-	const int32_t height = levelInstance_.getLevel()->getHeight();
-	const int32_t tableSize = width * height;
 
-	std::fill(occupiedByCreeps_.get(), occupiedByCreeps_.get() + tableSize, false);
+	// Find fields occupied by Creeps now
+	++tick_;
+	nowOccupied_.clear();
+	auto mark = [&](sf::Vector2i at) {
+		const int32_t index = at.y * width + at.x;
+		if (occupiedAt_[index] != tick_) {
+			occupiedAt_[index] = tick_;
+			nowOccupied_.push_back(index);
+		}
+	};
+
+	const auto & creeps = levelInstance_.getCreeps();
+	for (uint32_t i = 0; i < creeps.size(); ++i) {
+		mark(creeps.getWalkFrom(i));
+		mark(creeps.getWalkTo(i));
+	}
+
+	// Count only the fields which changed their state since the last update
+	for (auto index : nowOccupied_) {
+		if (!occupiedByCreeps_[index]) {
+			occupiedByCreeps_[index] = true;
+			if (!permanentlyOccupied_[index])
+				addRequired(index, 1);
+		}
+	}
 
-	// Forbid placing on fields occupied by Creeps
-	for (const auto & creep : levelInstance_.getCreeps()) {
-		for (auto point : creep->getOccupiedTurretPositions()) {
-			occupiedByCreeps_[point.y * width + point.x] = true;
+	for (auto index : occupied_) {
+		if (occupiedAt_[index] != tick_) {
+			occupiedByCreeps_[index] = false;
+			if (!permanentlyOccupied_[index])
+				addRequired(index, -1);
 		}
 	}
 
-	updateTowerRestrictions();
+	occupied_.swap(nowOccupied_);
 }
@@ -3,8 +3,9 @@
 #ifndef TDF_LEVEL_SERVICES_HPP
 #define TDF_LEVEL_SERVICES_HPP
 
+#include <memory>
+#include <vector>
 #include <SFML/System.hpp>
-#include <SFML/Graphics.hpp>
 
 class Level;
 class LevelInstance;
@@ -21,22 +22,51 @@ public:
 
 	// Returns next point on the grid, following the given point.
 	virtual P getNextStep(const P & point) const = 0;
+
+	// Returns how many steps it takes to reach the goal from the given point.
+	virtual int32_t getDistanceToGoal(const P & point) const = 0;
 };
 
+//! \brief Navigates Creeps through the grid along shortest paths.
+//! Each cell points to its neighbour closest to the goal, preferring the one
+//! below, above, to the right and to the left, in this order. The choice
+//! depends only on distances, so repairing them after a change gives the
+//! same paths as computing everything again.
 class GridNavigationProvider final : public NavigationProvider<sf::Vector2i>
 {
 private:
+	static const int32_t EMPTY = -1, FILLED = -2;
+	static const int32_t UNREACHABLE = 0x7fffffff;
+
 	LevelInstance & levelInstance_;
 	std::unique_ptr<int32_t[]> path_;
+	std::unique_ptr<int32_t[]> distance_;
+	//! Cells whose distance changes during an incremental update.
+	std::unique_ptr<bool[]> affected_;
+	std::vector<int32_t> region_;
 	sf::Vector2i goal_;
 
+	template<typename F>
+	void forEachNeighbour(int32_t index, F f) const;
+
+	//! Points the cell to its neighbour closest to the goal.
+	void choosePath(int32_t index);
+	void block(int32_t index);
+	void unblock(int32_t index);
+
 public:
 	GridNavigationProvider(LevelInstance & levelInstance, sf::Vector2i goal);
 	virtual sf::Vector2i getGoal() const override;
 	virtual sf::Vector2i getNextStep(const sf::Vector2i & point) const override;
+	virtual int32_t getDistanceToGoal(const sf::Vector2i & point) const override;
 
 	//! Updates navigation info.
 	void update();
+
+	//! \brief Updates navigation info after a Tower was placed on
+	//! or removed from the given position.
+	//! Only cells whose distance to the goal changes are visited.
+	void update(sf::Vector2i changed);
 };
 
 //! Tells if a tower can be placed at given position
@@ -51,24 +81,81 @@ public:
 class GridTowerPlacementOracle final : public TowerPlacementOracle<sf::Vector2i>
 {
 private:
+	//! A cell on the dfs stack and the next of its neighbours to visit.
+	struct frame_t
+	{
+		int32_t cell;
+		int32_t direction;
+	};
+
+	static const int32_t EMPTY = -1, ROOT = -2;
+
 	LevelInstance & levelInstance_;
 	std::unique_ptr<bool[]> permanentlyOccupied_;
-	std::unique_ptr<bool[]> validTurretPlaces_;
-	std::unique_ptr<bool[]> occupiedByCreeps_;
-	std::unique_ptr<int32_t[]> parents_;
-	std::unique_ptr<int32_t[]> pre_;
-	std::unique_ptr<int32_t[]> low_;
-	std::unique_ptr<int32_t[]> dp_;
+
+	//! Everything below is a cache, brought up to date by the first
+	//! query after Towers or Creeps changed.
+	mutable bool towersChanged_, creepsChanged_;
+	uint64_t changes_;
+
+	mutable std::unique_ptr<bool[]> occupiedByCreeps_;
+	//! Update in which a field was last found occupied by a Creep.
+	mutable std::unique_ptr<uint32_t[]> occupiedAt_;
+	mutable std::vector<int32_t> occupied_, nowOccupied_;
+	mutable uint32_t tick_;
+
+	//! dfs tree of fields reachable from the goal, which changes only
+	//! with Towers. The subtree of a field spans pre numbers from pre_
+	//! up to, but excluding, end_.
+	mutable std::unique_ptr<int32_t[]> parents_;
+	mutable std::unique_ptr<int32_t[]> pre_;
+	mutable std::unique_ptr<int32_t[]> low_;
+	mutable std::unique_ptr<int32_t[]> end_;
+	mutable std::unique_ptr<frame_t[]> stack_;
+	mutable int32_t reached_;
+
+	//! Fenwick tree counting fields which must stay reachable from the goal
+	//! (spawn points and fields occupied by Creeps), indexed by pre number.
+	mutable std::unique_ptr<int32_t[]> required_;
+
+	void addRequired(int32_t index, int32_t delta) const;
+	int32_t countRequired(int32_t begin, int32_t end) const;
+
+	//! Recalculates the dfs tree and counts of required fields.
+	void updateTowerRestrictions() const;
+
+	//! \brief Updates information about positions restricted by Creeps.
+	//! Only fields which Creeps entered or left since the last update
+	//! are visited.
+	void updateCreepRestrictions() const;
 
 public:
 	GridTowerPlacementOracle(LevelInstance & levelInstance);
 	virtual bool canPlaceTowerHere(const sf::Vector2i & at) const override;
 
-	//! Updates information about positions restricted by Towers.
-	void updateTowerRestrictions();
+	//! \brief Tells the oracle that a Tower was placed or sold.
+	//! Positions are analyzed again on the next query.
+	inline void invalidateTowerRestrictions()
+	{
+		towersChanged_ = true;
+		++changes_;
+	}
+
+	//! \brief Tells the oracle that fields taken by Creeps may have changed,
+	//! as one of them stepped on to another field, came or went. Their
+	//! fields are read on the next query, and answers may change only then.
+	inline void invalidateCreepRestrictions()
+	{
+		creepsChanged_ = true;
+		++changes_;
+	}
 
-	//! Updates information about positions restricted by Creeps.
-	void updateCreepRestrictions();
+	//! \brief Returns how many times positions were invalidated.
+	//! While the count stays the same, answers stay the same too.
+	inline uint64_t getChangeCount() const
+	{
+		return changes_;
+	}
 };
 
 #endif // TDF_LEVEL_SERVICES_HPP
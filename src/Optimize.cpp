@@ -0,0 +1,142 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "JobSystem.hpp"
+#include "LayoutOptimizer.hpp"
+#include "Level.hpp"
+#include "ToolSupport.hpp"
+#include "TowerLayout.hpp"
+
+// Searches for a tower layout keeping as many lives as possible in a level,
+// within a money budget, by playing candidate layouts headlessly on all cores.
+// Usage: TDOptimize <level.json> [--seeds N] [--first-seed S] [--budget N]
+//                   [--beam N] [--positions N] [--max-towers N]
+//                   [--max-ticks N] [--threads N] [--output file]
+// Every layout is played with seeds S .. S + N - 1. Without --budget towers
+// may cost as much as the games earn; --beam 1 makes the search greedy. The
+// best layout is printed, and written to --output in the form TDSimulator
+// and TDBalance read.
+
+static void printUsage(const char * argv0)
+{
+	std::cout << "Usage: " << argv0 << " <level.json> [--seeds N] [--first-seed S] [--budget N]"
+		<< " [--beam N] [--positions N] [--max-towers N] [--max-ticks N] [--threads N] [--output file]" << std::endl;
+}
+
+static void printScore(const LayoutOptimizer::score_t & score)
+{
+	std::cout << "lives " << score.lives << ", win rate " << 100.0 * score.winRate << "%, "
+		<< score.ticks << " ticks, spent " << score.spent;
+}
+
+int main(int argc, char ** argv)
+{
+	std::string levelPath, outputPath;
+	uint64_t seedCount = 8;
+	uint64_t firstSeed = 0;
+	uint32_t workerCount = JobSystem::getDefaultWorkerCount();
+
+	LayoutOptimizer::settings_t settings;
+	settings.beamWidth = 4;
+	settings.positions = 16;
+	settings.maxTowers = 64;
+	settings.maxTicks = DEFAULT_MAX_TICKS;
+	settings.budget = std::numeric_limits<int64_t>::max();
+
+	for (int i = 1; i < argc; ++i) {
+		if (!strcmp(argv[i], "--seeds") && i + 1 < argc)
+			seedCount = std::strtoull(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--first-seed") && i + 1 < argc)
+			firstSeed = std::strtoull(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--budget") && i + 1 < argc)
+			settings.budget = std::strtoll(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--beam") && i + 1 < argc)
+			settings.beamWidth = std::strtoull(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--positions") && i + 1 < argc)
+			settings.positions = std::strtoull(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--max-towers") && i + 1 < argc)
+			settings.maxTowers = std::strtoull(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--max-ticks") && i + 1 < argc)
+			settings.maxTicks = std::strtoll(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+			workerCount = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--output") && i + 1 < argc)
+			outputPath = argv[++i];
+		else if (argv[i][0] == '-' || !levelPath.empty()) {
+			printUsage(argv[0]);
+			return 1;
+		}
+		else
+			levelPath = argv[i];
+	}
+
+	if (levelPath.empty() || seedCount == 0 || settings.beamWidth == 0) {
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	try {
+		std::ifstream levelSource(levelPath);
+		if (!levelSource.is_open())
+			throw std::runtime_error("Cannot open " + levelPath);
+		auto level = std::make_shared<Level>(levelSource);
+
+		for (uint64_t i = 0; i < seedCount; ++i)
+			settings.seeds.push_back(firstSeed + i);
+
+		JobSystem jobs(workerCount);
+		LayoutOptimizer optimizer(level, settings);
+
+		std::cout << std::fixed << std::setprecision(2);
+		std::cout << "Level:        " << levelPath << std::endl;
+		std::cout << "Search:       beam " << settings.beamWidth << ", " << settings.positions
+			<< " positions, " << seedCount << " seeds from " << firstSeed;
+		if (settings.budget < std::numeric_limits<int64_t>::max())
+			std::cout << ", budget " << settings.budget;
+		std::cout << std::endl;
+
+		const auto start = std::chrono::steady_clock::now();
+		LayoutOptimizer::stats_t stats = LayoutOptimizer::stats_t();
+		const auto best = optimizer.optimize(jobs, [&stats](const LayoutOptimizer::stats_t & progress, const LayoutOptimizer::candidate_t & best) {
+			stats = progress;
+			std::cout << "Step " << std::setw(3) << stats.step << ":     " << stats.layouts << " layouts, best ";
+			printScore(best.score);
+			std::cout << std::endl;
+		});
+		const double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		std::cout << "Best:         ";
+		printScore(best.score);
+		std::cout << std::endl;
+		for (const auto & placement : best.layout.getPlacements()) {
+			std::cout << "  " << placement.towerName << " at " << placement.position.x << ", "
+				<< placement.position.y << " from tick " << placement.tick << std::endl;
+		}
+		std::cout << "Games:        " << stats.games << ", " << stats.playedTicks << " ticks played, "
+			<< stats.reusedTicks << " resumed from snapshots" << std::endl;
+		std::cout << "Threads:      " << jobs.getWorkerCount() + 1 << std::endl;
+		std::cout << "Wall time:    " << wallSeconds << " s" << std::endl;
+
+		if (!outputPath.empty()) {
+			std::ofstream output(outputPath);
+			if (!output.is_open())
+				throw std::runtime_error("Cannot open " + outputPath);
+			best.layout.write(output);
+		}
+
+		return 0;
+	}
+
+	catch (std::exception & err) {
+		std::cout << "Runtime error: " << err.what() << std::endl;
+		return 1;
+	}
+}
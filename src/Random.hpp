@@ -0,0 +1,71 @@
+#pragma once
+
+#ifndef TDF_RANDOM_HPP
+#define TDF_RANDOM_HPP
+
+#include <cstdint>
+
+#include "BinaryStream.hpp"
+
+//! \brief A small, fast pseudo-random number generator (xoshiro128**).
+//! Each LevelInstance owns one, so that a level played with the same seed
+//! and the same input always plays out the same.
+class Random
+{
+private:
+	uint32_t state_[4];
+
+	static inline uint32_t rotl(uint32_t x, int k)
+	{
+		return (x << k) | (x >> (32 - k));
+	}
+
+public:
+	explicit Random(uint64_t seed)
+	{
+		// Spread the seed over the whole state with splitmix64
+		for (int i = 0; i < 4; i += 2) {
+			uint64_t z = (seed += 0x9e3779b97f4a7c15ull);
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+			z ^= z >> 31;
+			state_[i] = (uint32_t)z;
+			state_[i + 1] = (uint32_t)(z >> 32);
+		}
+	}
+
+	inline uint32_t next()
+	{
+		const uint32_t result = rotl(state_[1] * 5, 7) * 9;
+		const uint32_t t = state_[1] << 9;
+
+		state_[2] ^= state_[0];
+		state_[3] ^= state_[1];
+		state_[1] ^= state_[2];
+		state_[0] ^= state_[3];
+		state_[2] ^= t;
+		state_[3] = rotl(state_[3], 11);
+
+		return result;
+	}
+
+	//! Returns a number from [0, 1).
+	inline float nextFloat()
+	{
+		return (next() >> 8) * (1.f / 16777216.f);
+	}
+
+	void save(BinaryWriter & writer) const
+	{
+		for (uint32_t word : state_)
+			writer.writeFixed(word, sizeof(word));
+	}
+
+	void load(BinaryReader & reader)
+	{
+		for (uint32_t & word : state_)
+			word = (uint32_t)reader.readFixed(sizeof(word));
+	}
+};
+
+#endif // TDF_RANDOM_HPP
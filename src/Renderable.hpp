@@ -8,13 +8,15 @@
 #include <SFML/Graphics.hpp>
 #include <SFML/System.hpp>
 
-//! A base class for a component which can be rendered, and hit-tested.
+#include "SpriteBatch.hpp"
+
+//! A base class for a component which can be rendered into a SpriteBatch, and hit-tested.
 class Renderable
 {
 public:
 	virtual ~Renderable() {}
 	virtual void update(const sf::Time&) {}
-	virtual void render(sf::RenderTarget & target) = 0;
+	virtual void render(SpriteBatch & batch) = 0;
 	virtual bool isHit(sf::Vector2f /*point*/) const
 	{
 		return false;
@@ -43,10 +45,10 @@ public:
 		children_.emplace_back(std::move(child));
 	}
 
-	virtual void render(sf::RenderTarget & target) override
+	virtual void render(SpriteBatch & batch) override
 	{
 		for (auto & child : children_)
-			child->render(target);
+			child->render(batch);
 	}
 
 	virtual bool isHit(sf::Vector2f point) const override
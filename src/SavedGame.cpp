@@ -0,0 +1,53 @@
+#include <cstring>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "BinaryStream.hpp"
+#include "Level.hpp"
+#include "SavedGame.hpp"
+
+// Layout of a saved game: "TDSG", format version (1 byte),
+// the Level description and the LevelInstance snapshot.
+// The snapshot carries a version of its own.
+
+static const char MAGIC[4] = { 'T', 'D', 'S', 'G' };
+static const uint8_t FORMAT_VERSION = 1;
+
+void SavedGame::write(std::ostream & target, const LevelInstance & levelInstance)
+{
+	BinaryWriter writer;
+	writer.writeBytes(MAGIC, sizeof(MAGIC));
+	writer.writeByte(FORMAT_VERSION);
+	writer.writeString(levelInstance.getLevel()->getDescription());
+	levelInstance.save(writer);
+
+	const std::string & buffer = writer.getBuffer();
+	target.write(buffer.data(), buffer.size());
+	if (!target)
+		throw std::runtime_error("Cannot write the saved game");
+}
+
+std::shared_ptr<LevelInstance> SavedGame::read(std::istream & source)
+{
+	const std::string data((std::istreambuf_iterator<char>(source)), std::istreambuf_iterator<char>());
+	BinaryReader reader(data);
+
+	char magic[sizeof(MAGIC)];
+	reader.readBytes(magic, sizeof(magic));
+	if (memcmp(magic, MAGIC, sizeof(MAGIC)))
+		throw std::runtime_error("Not a saved game");
+	if (reader.readByte() != FORMAT_VERSION)
+		throw std::runtime_error("Unsupported saved game version");
+
+	std::istringstream description(reader.readString());
+	auto level = std::make_shared<Level>(description);
+
+	// The seed is restored along with the rest of the state
+	auto levelInstance = std::make_shared<LevelInstance>(level, 0);
+	levelInstance->load(reader);
+	if (!reader.atEnd())
+		throw std::runtime_error("Saved game has trailing data");
+
+	return levelInstance;
+}
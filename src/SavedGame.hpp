@@ -0,0 +1,27 @@
+#pragma once
+
+#ifndef TDF_SAVED_GAME_HPP
+#define TDF_SAVED_GAME_HPP
+
+#include <istream>
+#include <memory>
+#include <ostream>
+
+class LevelInstance;
+
+//! \brief Stores a level in progress in a compact binary file.
+//! The file holds the description of the Level along with a snapshot of
+//! the LevelInstance, so it can be loaded without the original level file.
+class SavedGame
+{
+public:
+	//! Writes the LevelInstance along with its Level, with a single write to the stream.
+	static void write(std::ostream & target, const LevelInstance & levelInstance);
+
+	//! \brief Reads a Level and a LevelInstance saved by write.
+	//! Throws std::runtime_error if the file is malformed or of an unsupported
+	//! version, and whatever Level throws for a malformed description.
+	static std::shared_ptr<LevelInstance> read(std::istream & source);
+};
+
+#endif // TDF_SAVED_GAME_HPP
@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "Constants.hpp"
+#include "InputLog.hpp"
+#include "JobSystem.hpp"
+#include "Level.hpp"
+#include "ToolSupport.hpp"
+#include "TowerLayout.hpp"
+
+// Runs a level without a window, as fast as possible, and reports how
+// long simulation ticks take.
+// Usage: TDSimulator <level.json> [layout.json] [--max-ticks N] [--seed N]
+//                    [--record log] [--keyframes N] [--replay log] [--seek T]
+//                    [--threads N]
+// A log recorded in the game or with --record can be replayed instead of
+// a layout; its seed is then used and it runs until the recorded end.
+// --seek starts the replay at tick T, from the closest keyframe before it,
+// or at the end of the game if it ended before;
+// --keyframes sets how many ticks apart keyframes are recorded, 0 for none.
+// --threads sets how many worker threads help the main one, 0 runs serially;
+// the outcome is the same for any count.
+
+static void printUsage(const char * argv0)
+{
+	std::cout << "Usage: " << argv0 << " <level.json> [layout.json] [--max-ticks N] [--seed N]"
+		<< " [--record log] [--keyframes N] [--replay log] [--seek T] [--threads N]" << std::endl;
+}
+
+int main(int argc, char ** argv)
+{
+	std::string levelPath, layoutPath, recordPath, replayPath;
+	int64_t maxTicks = -1;
+	uint64_t seed = 0;
+	uint64_t keyframeInterval = Constants::KEYFRAME_INTERVAL;
+	int64_t seekTick = 0;
+	uint32_t workerCount = JobSystem::getDefaultWorkerCount();
+
+	for (int i = 1; i < argc; ++i) {
+		if (!strcmp(argv[i], "--max-ticks") && i + 1 < argc)
+			maxTicks = std::strtoll(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--seed") && i + 1 < argc)
+			seed = std::strtoull(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--record") && i + 1 < argc)
+			recordPath = argv[++i];
+		else if (!strcmp(argv[i], "--replay") && i + 1 < argc)
+			replayPath = argv[++i];
+		else if (!strcmp(argv[i], "--keyframes") && i + 1 < argc)
+			keyframeInterval = std::strtoull(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--seek") && i + 1 < argc)
+			seekTick = std::strtoll(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+			workerCount = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+		else if (levelPath.empty())
+			levelPath = argv[i];
+		else if (layoutPath.empty())
+			layoutPath = argv[i];
+		else {
+			printUsage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (levelPath.empty() || (!replayPath.empty() && !layoutPath.empty())) {
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	try {
+		std::ifstream levelSource(levelPath);
+		if (!levelSource.is_open())
+			throw std::runtime_error("Cannot open " + levelPath);
+		auto level = std::make_shared<Level>(levelSource);
+
+		std::unique_ptr<InputLog> replay;
+		if (!replayPath.empty()) {
+			std::ifstream replaySource(replayPath, std::ios::binary);
+			if (!replaySource.is_open())
+				throw std::runtime_error("Cannot open " + replayPath);
+			replay.reset(new InputLog(replaySource));
+			seed = replay->getSeed();
+			if (maxTicks < 0)
+				maxTicks = (int64_t)replay->getEndTick();
+		}
+		if (maxTicks < 0)
+			maxTicks = DEFAULT_MAX_TICKS;
+
+		JobSystem jobs(workerCount);
+		auto levelInstance = std::make_shared<LevelInstance>(level, seed);
+		levelInstance->setJobSystem(&jobs);
+		InputLog record(seed, keyframeInterval);
+		if (!recordPath.empty())
+			levelInstance->setRecorder(&record);
+
+		TowerLayout layout;
+		if (!layoutPath.empty()) {
+			std::ifstream layoutSource(layoutPath);
+			if (!layoutSource.is_open())
+				throw std::runtime_error("Cannot open " + layoutPath);
+			layout = TowerLayout(layoutSource);
+		}
+
+		typedef std::chrono::high_resolution_clock clock_t;
+		const sf::Time dt = sf::seconds(Constants::SECONDS_PER_FRAME);
+		std::vector<double> tickTimes;
+		tickTimes.reserve((size_t)std::min<int64_t>(maxTicks, DEFAULT_MAX_TICKS));
+
+		int32_t failedPlacements = 0;
+		int64_t tick = 0;
+		size_t replayed = 0;
+		if (!replay)
+			levelInstance->resume();
+
+		// A log recorded after loading a saved game starts from a keyframe
+		double seekSeconds = 0.0;
+		if (replay) {
+			seekTick = std::max(seekTick, (int64_t)replay->getStartTick());
+			const auto seekStart = clock_t::now();
+			replayed = replay->seek(*levelInstance, (uint64_t)seekTick);
+			seekSeconds = std::chrono::duration<double>(clock_t::now() - seekStart).count();
+			tick = seekTick = (int64_t)levelInstance->getTick();
+		}
+
+		jobs.resetStats();
+		const auto start = clock_t::now();
+		while (tick < maxTicks && !levelInstance->hasWon() && !levelInstance->hasLost()) {
+			const auto tickStart = clock_t::now();
+			failedPlacements += layout.apply(*levelInstance, tick);
+			if (replay)
+				replayed = replay->apply(*levelInstance, replayed);
+			levelInstance->update(dt);
+			const auto tickEnd = clock_t::now();
+
+			tickTimes.push_back(std::chrono::duration<double, std::micro>(tickEnd - tickStart).count());
+			++tick;
+		}
+		const double wallSeconds = std::chrono::duration<double>(clock_t::now() - start).count();
+
+		if (!recordPath.empty()) {
+			levelInstance->setRecorder(nullptr);
+			record.setEndTick(tick);
+			std::ofstream recordTarget(recordPath, std::ios::binary);
+			if (!recordTarget.is_open())
+				throw std::runtime_error("Cannot open " + recordPath);
+			record.write(recordTarget);
+		}
+
+		std::sort(tickTimes.begin(), tickTimes.end());
+		const double gameSeconds = tick * Constants::SECONDS_PER_FRAME;
+		const char * outcome = levelInstance->hasWon() ? "won"
+			: levelInstance->hasLost() ? "lost" : "undecided (tick limit reached)";
+
+		std::cout << std::fixed << std::setprecision(2);
+		std::cout << "Level:        " << levelPath << std::endl;
+		if (!layoutPath.empty())
+			std::cout << "Layout:       " << layoutPath << " (" << failedPlacements << " placements failed)" << std::endl;
+		if (replay) {
+			std::cout << "Replay:       " << replayPath << " (" << replayed << "/" << replay->getEntries().size()
+				<< " actions, " << replay->getKeyframes().size() << " keyframes)" << std::endl;
+		}
+		if (replay && seekTick > 0)
+			std::cout << "Seek:         to tick " << seekTick << " in " << seekSeconds * 1000.0 << " ms" << std::endl;
+		if (!recordPath.empty()) {
+			std::cout << "Recorded:     " << recordPath << " (" << record.getEntries().size()
+				<< " actions, " << record.getKeyframes().size() << " keyframes)" << std::endl;
+		}
+		std::cout << "Seed:         " << seed << std::endl;
+		std::cout << "Threads:      " << jobs.getWorkerCount() + 1 << std::endl;
+		if (wallSeconds > 0.0) {
+			// Share of the run each thread spent in simulation tasks, the main thread first
+			std::cout << "Utilisation: ";
+			for (const auto & stats : jobs.getStats()) {
+				std::cout << " " << 100.0 * stats.busySeconds / wallSeconds << "% ("
+					<< stats.tasks << " tasks, " << stats.steals << " stolen)";
+			}
+			std::cout << std::endl;
+		}
+		std::cout << "Outcome:      " << outcome << std::endl;
+		std::cout << "Lives:        " << levelInstance->getLives() << "/" << level->getStartingLives() << std::endl;
+		std::cout << "Money:        " << levelInstance->getMoney() << std::endl;
+		std::cout << "Ticks:        " << tick << " (" << gameSeconds << " s of game time)" << std::endl;
+		std::cout << "Wall time:    " << wallSeconds << " s" << std::endl;
+		if (wallSeconds > 0.0) {
+			std::cout << "Ticks/sec:    " << tick / wallSeconds
+				<< " (" << gameSeconds / wallSeconds << "x real time)" << std::endl;
+		}
+		std::cout << "Tick time:    p50 " << percentile(tickTimes, 0.5) << " us, p99 "
+			<< percentile(tickTimes, 0.99) << " us" << std::endl;
+		std::cout << "Bullets:      " << levelInstance->getBullets().getAddedCount() << " shot, "
+			<< levelInstance->getBullets().getAllocationCount() << " allocations" << std::endl;
+
+		return levelInstance->hasWon() ? 0 : 2;
+	}
+
+	catch (std::exception & err) {
+		std::cout << "Runtime error: " << err.what() << std::endl;
+		return 1;
+	}
+}
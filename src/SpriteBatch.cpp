@@ -0,0 +1,96 @@
+#include "SpriteBatch.hpp"
+
+SpriteBatch::SpriteBatch()
+	: usedLayers_(0)
+{
+}
+
+std::vector<sf::Vertex> & SpriteBatch::getVertices(const sf::Texture * texture)
+{
+	for (size_t i = 0; i < usedLayers_; ++i) {
+		if (layers_[i].texture == texture)
+			return layers_[i].vertices;
+	}
+
+	if (usedLayers_ == layers_.size())
+		layers_.push_back({ nullptr, {} });
+
+	layer_t & layer = layers_[usedLayers_++];
+	layer.texture = texture;
+	return layer.vertices;
+}
+
+void SpriteBatch::add(const sf::Sprite & sprite, const sf::Transform & transform)
+{
+	const sf::Transform combined = transform_ * transform * sprite.getTransform();
+	const sf::FloatRect bounds = sprite.getLocalBounds();
+	const sf::IntRect rect = sprite.getTextureRect();
+	const sf::Color color = sprite.getColor();
+
+	const float left = (float)rect.left;
+	const float top = (float)rect.top;
+	const float right = left + rect.width;
+	const float bottom = top + rect.height;
+
+	const sf::Vertex corners[] = {
+		sf::Vertex(combined.transformPoint(0.f, 0.f), color, { left, top }),
+		sf::Vertex(combined.transformPoint(bounds.width, 0.f), color, { right, top }),
+		sf::Vertex(combined.transformPoint(bounds.width, bounds.height), color, { right, bottom }),
+		sf::Vertex(combined.transformPoint(0.f, bounds.height), color, { left, bottom })
+	};
+
+	auto & vertices = getVertices(sprite.getTexture());
+	vertices.insert(vertices.end(), { corners[0], corners[1], corners[2] });
+	vertices.insert(vertices.end(), { corners[0], corners[2], corners[3] });
+}
+
+void SpriteBatch::add(const sf::Shape & shape, const sf::Transform & transform)
+{
+	const size_t count = shape.getPointCount();
+	if (count < 3)
+		return;
+
+	// Texture coordinates follow the bounds of the points, as in sf::Shape
+	const sf::Transform combined = transform_ * transform * shape.getTransform();
+	const sf::FloatRect bounds = shape.getLocalBounds();
+	const sf::IntRect rect = shape.getTextureRect();
+	const sf::Color color = shape.getFillColor();
+
+	auto vertex = [&](size_t index) {
+		const sf::Vector2f point = shape.getPoint(index);
+		const float u = bounds.width > 0.f ? (point.x - bounds.left) / bounds.width : 0.f;
+		const float v = bounds.height > 0.f ? (point.y - bounds.top) / bounds.height : 0.f;
+		return sf::Vertex(combined.transformPoint(point), color,
+			{ rect.left + rect.width * u, rect.top + rect.height * v });
+	};
+
+	// Shapes are convex, so a fan around the first point covers them
+	auto & vertices = getVertices(shape.getTexture());
+	const sf::Vertex first = vertex(0);
+	sf::Vertex previous = vertex(1);
+	for (size_t i = 2; i < count; ++i) {
+		const sf::Vertex current = vertex(i);
+		vertices.insert(vertices.end(), { first, previous, current });
+		previous = current;
+	}
+}
+
+void SpriteBatch::addLine(const sf::Vertex & from, const sf::Vertex & to)
+{
+	lines_.push_back(sf::Vertex(transform_.transformPoint(from.position), from.color, from.texCoords));
+	lines_.push_back(sf::Vertex(transform_.transformPoint(to.position), to.color, to.texCoords));
+}
+
+void SpriteBatch::draw(sf::RenderTarget & target)
+{
+	for (size_t i = 0; i < usedLayers_; ++i) {
+		auto & vertices = layers_[i].vertices;
+		target.draw(vertices.data(), vertices.size(), sf::Triangles, layers_[i].texture);
+		vertices.clear();
+	}
+	usedLayers_ = 0;
+
+	if (!lines_.empty())
+		target.draw(lines_.data(), lines_.size(), sf::Lines);
+	lines_.clear();
+}
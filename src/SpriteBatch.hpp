@@ -0,0 +1,47 @@
+#pragma once
+
+#ifndef TDF_SPRITE_BATCH_HPP
+#define TDF_SPRITE_BATCH_HPP
+
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+//! \brief Collects sprites, shapes and lines of many objects and draws
+//! everything sharing a texture with a single draw call.
+//! Layers are drawn in the order their textures were first added in,
+//! lines go last. Shape outlines are not supported.
+class SpriteBatch
+{
+private:
+	struct layer_t
+	{
+		const sf::Texture * texture;
+		std::vector<sf::Vertex> vertices;
+	};
+
+	//! Layers beyond usedLayers_ are kept only for their storage.
+	std::vector<layer_t> layers_;
+	size_t usedLayers_;
+	std::vector<sf::Vertex> lines_;
+	sf::Transform transform_;
+
+	std::vector<sf::Vertex> & getVertices(const sf::Texture * texture);
+
+public:
+	SpriteBatch();
+
+	void add(const sf::Sprite & sprite, const sf::Transform & transform = sf::Transform::Identity);
+	void add(const sf::Shape & shape, const sf::Transform & transform = sf::Transform::Identity);
+	void addLine(const sf::Vertex & from, const sf::Vertex & to);
+
+	//! Sets a transform applied to everything added from now on.
+	inline void setTransform(const sf::Transform & transform)
+	{
+		transform_ = transform;
+	}
+
+	//! Draws everything added since the last call, and empties the batch.
+	void draw(sf::RenderTarget & target);
+};
+
+#endif // TDF_SPRITE_BATCH_HPP
@@ -0,0 +1,24 @@
+#pragma once
+
+#ifndef TDF_TOOL_SUPPORT_HPP
+#define TDF_TOOL_SUPPORT_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Helpers shared by the command line tools: TDSimulator, TDBalance and TDOptimize.
+
+//! Ticks after which a game is stopped unless --max-ticks says otherwise.
+static const int64_t DEFAULT_MAX_TICKS = 60 * 60 * 60; // One hour of game time
+
+//! Returns the value below which the fraction p of the sorted values lies, 0 without values.
+inline double percentile(const std::vector<double> & sorted, double p)
+{
+	if (sorted.empty())
+		return 0.0;
+	const size_t index = std::min(sorted.size() - 1, (size_t)(p * sorted.size()));
+	return sorted[index];
+}
+
+#endif // TDF_TOOL_SUPPORT_HPP
@@ -1,22 +1,19 @@
-#include <SFGUI/Widgets.hpp>
 #include "../Bullet/Bullet.hpp"
 #include "../Bullet/BulletFactory.hpp"
 #include "../Level.hpp"
 #include "Tower.hpp"
+#include "TowerFactory.hpp"
 
-void Tower::update(sf::Time dt, BulletFactory & bulletFactory, CreepQueryService & queryService)
+bool Tower::aim(sf::Time dt, const CreepQueryService & queryService)
 {
 	targetingComponent_->update(queryService);
-	auto target = targetingComponent_->getTargetedCreep();
-	if (target) {
-		bulletFactory.setTarget(target);
-		shootingComponent_->update(dt, bulletFactory);
-	}
+	return targetingComponent_->getTargetedCreep() && shootingComponent_->charge(dt);
 }
 
-void Tower::render(sf::RenderTarget & target)
+void Tower::shoot(BulletFactory & bulletFactory, Random & random)
 {
-	displayComponent_->render(target);
+	bulletFactory.setTarget(targetingComponent_->getTargetedCreep());
+	shootingComponent_->shoot(bulletFactory, random);
 }
 
 sf::Vector2f Tower::getPosition() const
@@ -24,26 +21,21 @@ sf::Vector2f Tower::getPosition() const
 	return position_;
 }
 
-bool Tower::isHit(sf::Vector2f point) const
+void Tower::save(BinaryWriter & writer) const
 {
-	const sf::FloatRect rect = {
-		position_.x - 0.5f, position_.y - 0.5f,
-		1.f, 1.f
-	};
-	return rect.contains(point);
+	writer.writeString(typeName_);
+	writer.writeVector(position_);
+	targetingComponent_->save(writer);
+	shootingComponent_->save(writer);
 }
 
-sfg::Widget::Ptr Tower::getPanel(std::shared_ptr<LevelInstance> levelInstance)
+Tower Tower::load(BinaryReader & reader, const CreepStore & creeps)
 {
-	auto label = sfg::Label::Create("Tower #" + std::to_string((intptr_t)this));
+	const std::string typeName = reader.readString();
+	const sf::Vector2f position = reader.readVector2f();
 
-	auto sellButton = sfg::Button::Create("Sell for " + std::to_string(sellCost_));
-	sellButton->GetSignal(sfg::Button::OnLeftClick).Connect([this, levelInstance]() {
-		levelInstance->sellTower(this);
-	});
-
-	auto layout = sfg::Box::Create(sfg::Box::Orientation::VERTICAL);
-	layout->PackEnd(label, false);
-	layout->PackEnd(sellButton, false);
-	return layout;
+	Tower tower = TowerFactory::getTowerTypeInfo(typeName).construct(position);
+	tower.targetingComponent_->load(reader, creeps);
+	tower.shootingComponent_->load(reader);
+	return tower;
 }
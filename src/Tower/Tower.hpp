@@ -4,11 +4,8 @@
 #define TDF_TOWER_HPP
 
 #include <memory>
+#include <string>
 #include <SFML/System.hpp>
-#include <SFML/Graphics.hpp>
-#include "../Selectable.hpp"
-#include "../Renderable.hpp"
-#include "TowerDisplayComponent.hpp"
 #include "TowerShootingComponent.hpp"
 #include "TowerTargetingComponent.hpp"
 
@@ -24,42 +21,67 @@ public:
 
 class BulletFactory;
 class CreepQueryService;
+class Random;
 
 //! Represents a Tower placed on the grid.
-class Tower final : public Selectable, public Renderable
+class Tower final
 {
 private:
+	std::string typeName_;
 	sf::Vector2f position_;
 	int sellCost_;
 	std::unique_ptr<TowerTargetingComponent> targetingComponent_;
 	std::unique_ptr<TowerShootingComponent> shootingComponent_;
-	std::unique_ptr<TowerDisplayComponent> displayComponent_;
 public:
 	Tower(
+		const std::string & typeName,
 		sf::Vector2f position,
 		int sellCost,
 		std::unique_ptr<TowerTargetingComponent> targeting,
-		std::unique_ptr<TowerShootingComponent> shooting,
-		std::unique_ptr<TowerDisplayComponent> display)
-		: position_(position)
+		std::unique_ptr<TowerShootingComponent> shooting)
+		: typeName_(typeName)
+		, position_(position)
 		, sellCost_(sellCost)
 		, targetingComponent_(std::move(targeting))
 		, shootingComponent_(std::move(shooting))
-		, displayComponent_(std::move(display))
 	{}
 
-	void update(sf::Time dt, BulletFactory & bulletFactory, CreepQueryService & queryService);
+	//! \brief Chooses a target and charges the Tower, returns if it should shoot.
+	//! Changes nothing but the Tower, so Towers may aim in parallel.
+	bool aim(sf::Time dt, const CreepQueryService & queryService);
+
+	//! Shoots at the target chosen by aim.
+	void shoot(BulletFactory & bulletFactory, Random & random);
 
-	virtual void render(sf::RenderTarget & target) override;
 	sf::Vector2f getPosition() const;
 
-	virtual bool isHit(sf::Vector2f point) const override;
-	virtual sfg::Widget::Ptr getPanel(std::shared_ptr<LevelInstance> levelInstance) override;
+	const std::string & getTypeName() const
+	{
+		return typeName_;
+	}
+
+	CreepHandle getTargetedCreep() const
+	{
+		return targetingComponent_->getTargetedCreep();
+	}
 
-	int getSellCost()
+	//! Returns how many bullets this Tower has shot so far.
+	uint32_t getShotCount() const
+	{
+		return shootingComponent_->getShotCount();
+	}
+
+	int getSellCost() const
 	{
 		return sellCost_;
 	}
+
+	void save(BinaryWriter & writer) const;
+
+	//! \brief Creates a saved Tower anew with TowerFactory, then restores its state.
+	//! Its target has to be one of the Creeps in the store. Throws
+	//! std::runtime_error if the saved data is malformed.
+	static Tower load(BinaryReader & reader, const CreepStore & creeps);
 };
 
 #endif // TDF_TOWER_HPP
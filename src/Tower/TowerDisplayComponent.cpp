@@ -1,9 +1,8 @@
 // For MSVC's <cmath> to work
 #define _USE_MATH_DEFINES
 #include <cmath>
-#include "../Creep/Creep.hpp"
+#include "Tower.hpp"
 #include "TowerDisplayComponent.hpp"
-#include "TowerTargetingComponent.hpp"
 
 TowerSimpleDisplayComponent::TowerSimpleDisplayComponent(
 		sf::Vector2f position,
@@ -18,17 +17,20 @@ TowerSimpleDisplayComponent::TowerSimpleDisplayComponent(
 	sprite_.setScale(1.f/32.f, 1.f/32.f);
 }
 
-void TowerSimpleDisplayComponent::render(sf::RenderTarget & target)
+void TowerSimpleDisplayComponent::render(SpriteBatch & batch)
 {
-	target.draw(sprite_);
+	batch.add(sprite_);
 }
 
 TowerTargettingDisplayComponent::TowerTargettingDisplayComponent(
-	TowerTargetingComponent & targeting,
+	const EntityRegistry<Tower> & towers, Handle<Tower> tower,
+	const CreepStore & creeps,
 	sf::Vector2f position,
 	const sf::Texture & texture,
 	const sf::Texture& textureHead)
-	: targetingComponent_(targeting)
+	: towers_(towers)
+	, tower_(tower)
+	, creeps_(creeps)
 	, angle_(0.f)
 	, position_(position)
 {
@@ -46,18 +48,18 @@ TowerTargettingDisplayComponent::TowerTargettingDisplayComponent(
 	barrelShape_.setOrigin(0.5f, 0.5f);
 }
 
-void TowerTargettingDisplayComponent::render(sf::RenderTarget & target)
+void TowerTargettingDisplayComponent::render(SpriteBatch & batch)
 {
-	auto targeted = targetingComponent_.getTargetedCreep();
+	auto targeted = towers_.find(tower_)->getTargetedCreep();
 
-	if (targeted) {
-		const auto difference = targeted->getPosition() - position_;
+	if (creeps_.contains(targeted)) {
+		const auto difference = creeps_.getPosition(creeps_.indexOf(targeted)) - position_;
 		angle_ = (float)(atan2(difference.y, difference.x) * (180.f / M_PI));
 	}
 
 	sf::Transform transform;
 	transform.translate(position_ + sf::Vector2f(0.5f, 0.5f)).rotate(angle_);
 
-	target.draw(sprite_);
-	target.draw(barrelShape_, transform);
+	batch.add(sprite_);
+	batch.add(barrelShape_, transform);
 }
@@ -4,12 +4,13 @@
 #define TDF_TOWER_DISPLAY_COMPONENT_HPP
 
 #include <SFML/System.hpp>
+#include <SFML/Graphics.hpp>
 
+#include "../EntityRegistry.hpp"
 #include "../Renderable.hpp"
-#include "../Game.hpp"
+#include "../Creep/CreepStore.hpp"
 
-class TowerTargetingComponent;
-class Game;
+class Tower;
 
 //! A Tower component implementing the look of the tower.
 class TowerDisplayComponent : public Renderable {};
@@ -24,7 +25,7 @@ private:
 public:
 	TowerSimpleDisplayComponent(
 		sf::Vector2f position, const sf::Texture& texture);
-	virtual void render(sf::RenderTarget & target) override;
+	virtual void render(SpriteBatch & batch) override;
 };
 
 //! A simple look for the tower with targetting gun
@@ -33,15 +34,18 @@ class TowerTargettingDisplayComponent final : public TowerDisplayComponent
 private:
 	sf::Sprite sprite_;
 	sf::RectangleShape barrelShape_;
-	TowerTargetingComponent & targetingComponent_;
+	const EntityRegistry<Tower> & towers_;
+	Handle<Tower> tower_;
+	const CreepStore & creeps_;
 	float angle_;
 	sf::Vector2f position_;
 
 public:
 	TowerTargettingDisplayComponent(
-			TowerTargetingComponent & targeting,
+			const EntityRegistry<Tower> & towers, Handle<Tower> tower,
+			const CreepStore & creeps,
 			sf::Vector2f position, const sf::Texture& texture, const sf::Texture& textureHead);
-	virtual void render(sf::RenderTarget & target) override;
+	virtual void render(SpriteBatch & batch) override;
 };
 
 #endif // TDF_TOWER_DISPLAY_COMPONENT_HPP
@@ -1,109 +1,95 @@
 #include <memory>
-#include <json.hpp>
+#include <stdexcept>
 #include "../MakeUnique.hpp"
 #include "Tower.hpp"
-#include "TowerDisplayComponent.hpp"
 #include "TowerShootingComponent.hpp"
 #include "TowerTargetingComponent.hpp"
 #include "TowerFactory.hpp"
 
-using json = nlohmann::json;
-
 static std::vector<std::pair<std::string, towerTypeInfo_t>> typeInfos_ = []()
 {
 	std::vector<std::pair<std::string, towerTypeInfo_t>> ret;
 
 	ret.push_back({ "Tower", {
 		35, // Cost
-		[](sf::Vector2f position, Game & game__) -> std::shared_ptr<Tower> {
+		[](sf::Vector2f position) -> Tower {
 			auto targeting = std::make_unique<TowerClosestTargetingComponent>(position, 3.f);
-			auto shooting = std::make_unique<TowerLinearShootingComponent>(1.f, "GenericBullet", game__.getSound("Tower"));
-			auto display = std::make_unique<TowerTargettingDisplayComponent>(*targeting.get(),
-				position, game__.getTexture("Tower"), game__.getTexture("TowerHead"));
-			return std::make_shared<Tower>(
+			auto shooting = std::make_unique<TowerLinearShootingComponent>(1.f, "GenericBullet");
+			return Tower(
+				"Tower",
 				position,
 				35,
 				std::move(targeting),
-				std::move(shooting),
-				std::move(display));
+				std::move(shooting));
 		}}});
 
 	ret.push_back({ "LongRangeTower", {
 			50, // Cost
-			[](sf::Vector2f position, Game & game__) -> std::shared_ptr<Tower> {
+			[](sf::Vector2f position) -> Tower {
 				auto targeting = std::make_unique<TowerClosestTargetingComponent>(position, 8.f);
-				auto shooting = std::make_unique<TowerLinearShootingComponent>(2.f, "GenericBullet", game__.getSound("Tower"));
-				auto display = std::make_unique<TowerTargettingDisplayComponent>(*targeting.get(),
-					position, game__.getTexture("Tower"), game__.getTexture("TowerHead"));
-				return std::make_shared<Tower>(
+				auto shooting = std::make_unique<TowerLinearShootingComponent>(2.f, "GenericBullet");
+				return Tower(
+						"LongRangeTower",
 						position,
 						50,
 						std::move(targeting),
-						std::move(shooting),
-						std::move(display));
+						std::move(shooting));
 			}
 	}});
 
 	ret.push_back({ "LaserTower", {
 			100, // Cost
-			[](sf::Vector2f position, Game & game__) -> std::shared_ptr<Tower> {
+			[](sf::Vector2f position) -> Tower {
 				auto targeting = std::make_unique<TowerClosestTargetingComponent>(position, 10.f);
-				auto shooting = std::make_unique<TowerLinearShootingComponent>(0.25f, "LaserBullet", game__.getSound("Laser"));
-				auto display = std::make_unique<TowerTargettingDisplayComponent>(*targeting.get(),
-					position, game__.getTexture("Tower"), game__.getTexture("TowerHead"));
-				return std::make_shared<Tower>(
+				auto shooting = std::make_unique<TowerLinearShootingComponent>(0.25f, "LaserBullet");
+				return Tower(
+						"LaserTower",
 						position,
 						100,
 						std::move(targeting),
-						std::move(shooting),
-						std::move(display));
+						std::move(shooting));
 			}
 	}});
 
 	ret.push_back({ "Wall", {
 			20, // Cost
-			[](sf::Vector2f position, Game & game__) -> std::shared_ptr<Tower> {
+			[](sf::Vector2f position) -> Tower {
 				auto targeting = std::make_unique<TowerTargetingComponent>();
 				auto shooting = std::make_unique<TowerShootingComponent>();
-				auto display = std::make_unique<TowerSimpleDisplayComponent>(position, game__.getTexture("Wall"));
-				return std::make_shared<Tower>(
+				return Tower(
+						"Wall",
 						position,
 						20,
 						std::move(targeting),
-						std::move(shooting),
-						std::move(display));
+						std::move(shooting));
 			}
 	}});
 
 	ret.push_back({ "SlownessTower", {
 			500, // Cost
-			[](sf::Vector2f position, Game & game__) -> std::shared_ptr<Tower> {
+			[](sf::Vector2f position) -> Tower {
 				auto targeting = std::make_unique<TowerClosestTargetingComponent>(position, 4.f);
-				auto shooting = std::make_unique<TowerLinearShootingComponent>(3.f, "SlownessBullet", game__.getSound("Tower"));
-				auto display = std::make_unique<TowerTargettingDisplayComponent>(*targeting.get(),
-																				 position, game__.getTexture("Tower"),game__.getTexture("TowerHead"));
-				return std::make_shared<Tower>(
+				auto shooting = std::make_unique<TowerLinearShootingComponent>(3.f, "SlownessBullet");
+				return Tower(
+						"SlownessTower",
 						position,
 						500,
 						std::move(targeting),
-						std::move(shooting),
-						std::move(display));
+						std::move(shooting));
 			}
 	}});
 
 	ret.push_back({ "WeaknessTower", {
 			500, // Cost
-			[](sf::Vector2f position, Game & game__) -> std::shared_ptr<Tower> {
+			[](sf::Vector2f position) -> Tower {
 				auto targeting = std::make_unique<TowerClosestTargetingComponent>(position, 4.f);
-				auto shooting = std::make_unique<TowerLinearShootingComponent>(3.f, "WeaknessBullet", game__.getSound("Tower"));
-				auto display = std::make_unique<TowerTargettingDisplayComponent>(*targeting.get(),
-																				 position, game__.getTexture("Tower"),game__.getTexture("TowerHead"));
-				return std::make_shared<Tower>(
+				auto shooting = std::make_unique<TowerLinearShootingComponent>(3.f, "WeaknessBullet");
+				return Tower(
+						"WeaknessTower",
 						position,
 						500,
 						std::move(targeting),
-						std::move(shooting),
-						std::move(display));
+						std::move(shooting));
 			}
 	}});
 
@@ -4,17 +4,15 @@
 #define TDF_TOWER_FACTORY_HPP
 
 #include <functional>
-#include <memory>
+#include <string>
 #include <vector>
 #include <SFML/System.hpp>
-
-class Tower;
-class Game;
+#include "Tower.hpp"
 
 struct towerTypeInfo_t
 {
 	int32_t cost;
-	std::function<std::shared_ptr<Tower>(sf::Vector2f position, Game &game__)> construct;
+	std::function<Tower(sf::Vector2f position)> construct;
 };
 
 //! Its sole purpose is to create Turrets.
@@ -1,23 +1,35 @@
-#include <SFML/Audio/SoundBuffer.hpp>
 #include "../Bullet/BulletFactory.hpp"
+#include "../Random.hpp"
 #include "../Tower/TowerShootingComponent.hpp"
 
-TowerLinearShootingComponent::TowerLinearShootingComponent(float shotsPerSecond, std::string bulletType,
-														   const sf::SoundBuffer &sound)
+TowerLinearShootingComponent::TowerLinearShootingComponent(float shotsPerSecond, std::string bulletType)
 	: charge_(0.f)
 	, maxCharge_(shotsPerSecond)
 	, bulletType_(bulletType)
-	, sound_(sound)
 {
 }
 
-void TowerLinearShootingComponent::update(sf::Time dt, BulletFactory & bulletFactory)
+bool TowerLinearShootingComponent::charge(sf::Time dt)
 {
 	charge_ -= dt.asSeconds();
+	return charge_ <= 0.f;
+}
+
+void TowerLinearShootingComponent::shoot(BulletFactory & bulletFactory, Random & random)
+{
+	bulletFactory.shoot(bulletType_);
+	++shotCount_;
+	charge_ += maxCharge_ + random.nextFloat() / 4.f;
+}
 
-	if (charge_ <= 0.f) {
-		sound_.play();
-		bulletFactory.shoot(bulletType_);
-		charge_ += maxCharge_ + (rand()%1000)/4000.f;
-	}
+void TowerLinearShootingComponent::save(BinaryWriter & writer) const
+{
+	TowerShootingComponent::save(writer);
+	writer.writeFloat(charge_);
+}
+
+void TowerLinearShootingComponent::load(BinaryReader & reader)
+{
+	TowerShootingComponent::load(reader);
+	charge_ = reader.readFloat();
 }
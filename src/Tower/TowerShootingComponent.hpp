@@ -3,31 +3,65 @@
 #ifndef TDF_TOWER_SHOOTING_COMPONENT
 #define TDF_TOWER_SHOOTING_COMPONENT
 
+#include <cstdint>
+#include <string>
 #include <SFML/System.hpp>
-#include <SFML/Audio.hpp>
+
+#include "../BinaryStream.hpp"
 
 class BulletFactory;
+class Random;
 
 //! A Tower component which decides when to shoot, and how.
 class TowerShootingComponent
 {
+protected:
+	uint32_t shotCount_;
+
 public:
+	TowerShootingComponent() : shotCount_(0) {}
 	virtual ~TowerShootingComponent() {}
-	virtual void update(sf::Time /*dt*/, BulletFactory & /*bulletFactory*/) {};
+
+	//! Advances the component by dt, returns if it is ready to shoot.
+	virtual bool charge(sf::Time /*dt*/)
+	{
+		return false;
+	}
+
+	//! Shoots, called after charge returned true.
+	virtual void shoot(BulletFactory & /*bulletFactory*/, Random & /*random*/) {}
+
+	//! Returns how many bullets were shot so far.
+	uint32_t getShotCount() const
+	{
+		return shotCount_;
+	}
+
+	//! Saves the state which changes as the Tower shoots.
+	virtual void save(BinaryWriter & writer) const
+	{
+		writer.writeUnsigned(shotCount_);
+	}
+
+	virtual void load(BinaryReader & reader)
+	{
+		shotCount_ = (uint32_t)reader.readUnsigned();
+	}
 };
 
-//! Shoots a bullet every n seconds.
+//! Shoots a bullet every n seconds, plus a random delay of up to a quarter of a second.
 class TowerLinearShootingComponent final : public TowerShootingComponent
 {
 private:
 	float charge_, maxCharge_;
 	std::string bulletType_;
-	sf::Sound sound_;
 
 public:
-	TowerLinearShootingComponent(float shotsPerSecond, std::string bulletType,
-								 const sf::SoundBuffer &sound);
-	virtual void update(sf::Time dt, BulletFactory & bulletFactory) override;
+	TowerLinearShootingComponent(float shotsPerSecond, std::string bulletType);
+	virtual bool charge(sf::Time dt) override;
+	virtual void shoot(BulletFactory & bulletFactory, Random & random) override;
+	virtual void save(BinaryWriter & writer) const override;
+	virtual void load(BinaryReader & reader) override;
 };
 
 #endif // TDF_TOWER_SHOOTING_COMPONENT
@@ -1,4 +1,3 @@
-#include "../Creep/Creep.hpp"
 #include "../Creep/CreepQueryService.hpp"
 #include "TowerTargetingComponent.hpp"
 
@@ -7,23 +6,36 @@ TowerClosestTargetingComponent::TowerClosestTargetingComponent(sf::Vector2f posi
 	, range_(range)
 {}
 
-std::shared_ptr<Creep> TowerClosestTargetingComponent::chooseCreep(CreepQueryService & service)
+CreepHandle TowerClosestTargetingComponent::chooseCreep(const CreepQueryService & service)
 {
 	return service.getClosestCreep(position_, range_);
 }
 
-std::shared_ptr<Creep> TowerTargetingLockOnComponent::chooseCreep(CreepQueryService & service)
+CreepHandle TowerTargetingLockOnComponent::chooseCreep(const CreepQueryService & service)
 {
+	const auto & creeps = service.getCreeps();
 	auto creep = base_->getTargetedCreep();
-	if (!creep || !creep->isAlive()) {
+	if (!creeps.contains(creep) || !creeps.isAlive(creeps.indexOf(creep))) {
 		base_->update(service);
 		return base_->getTargetedCreep();
 	}
 	else {
-		return nullptr;
+		return CreepHandle();
 	}
 }
 
 TowerTargetingLockOnComponent::TowerTargetingLockOnComponent(std::shared_ptr<TowerTargetingComponent> base)
 	: base_(base)
 {}
+
+void TowerTargetingLockOnComponent::save(BinaryWriter & writer) const
+{
+	TowerTargetingComponent::save(writer);
+	base_->save(writer);
+}
+
+void TowerTargetingLockOnComponent::load(BinaryReader & reader, const CreepStore & creeps)
+{
+	TowerTargetingComponent::load(reader, creeps);
+	base_->load(reader, creeps);
+}
@@ -3,35 +3,49 @@
 #ifndef TDF_TOWER_TARGETING_COMPONENT_HPP
 #define TDF_TOWER_TARGETING_COMPONENT_HPP
 
+#include <limits>
 #include <memory>
 
 #include <SFML/System.hpp>
 
-class Creep;
+#include "../Creep/CreepStore.hpp"
+
 class CreepQueryService;
 
 //! Chooses the Creep for Tower to shoot at.
 class TowerTargetingComponent
 {
 private:
-	std::shared_ptr<Creep> targetedCreep_;
+	CreepHandle targetedCreep_;
 
 protected:
-	virtual std::shared_ptr<Creep> chooseCreep(CreepQueryService & /*service*/)
+	virtual CreepHandle chooseCreep(const CreepQueryService & /*service*/)
 	{
-		return nullptr;
+		return CreepHandle();
 	}
 
 public:
 	virtual ~TowerTargetingComponent() {}
-	inline void update(CreepQueryService & service)
+	inline void update(const CreepQueryService & service)
 	{
 		targetedCreep_ = chooseCreep(service);
 	}
-	inline std::shared_ptr<Creep> getTargetedCreep() const
+	inline CreepHandle getTargetedCreep() const
 	{
 		return targetedCreep_;
 	}
+
+	//! Saves the state which changes as the Tower chooses targets.
+	virtual void save(BinaryWriter & writer) const
+	{
+		targetedCreep_.save(writer);
+	}
+
+	//! Loads the saved state; targets have to be Creeps of the store.
+	virtual void load(BinaryReader & reader, const CreepStore & creeps)
+	{
+		targetedCreep_ = creeps.loadHandle(reader);
+	}
 };
 
 //! Chooses the closest Creep.
@@ -42,7 +56,7 @@ private:
 	float range_;
 
 protected:
-	virtual std::shared_ptr<Creep> chooseCreep(CreepQueryService & service) override;
+	virtual CreepHandle chooseCreep(const CreepQueryService & service) override;
 
 public:
 	TowerClosestTargetingComponent(sf::Vector2f position, float range = std::numeric_limits<float>::infinity());
@@ -56,10 +70,13 @@ private:
 	std::shared_ptr<TowerTargetingComponent> base_;
 
 protected:
-	virtual std::shared_ptr<Creep> chooseCreep(CreepQueryService & service) override;
+	virtual CreepHandle chooseCreep(const CreepQueryService & service) override;
 
 public:
 	TowerTargetingLockOnComponent(std::shared_ptr<TowerTargetingComponent> base);
+
+	virtual void save(BinaryWriter & writer) const override;
+	virtual void load(BinaryReader & reader, const CreepStore & creeps) override;
 };
 
 #endif // TDF_TOWER_TARGETING_COMPONENT_HPP
@@ -0,0 +1,66 @@
+#include <SFGUI/Widgets.hpp>
+#include "../MakeUnique.hpp"
+#include "../Game.hpp"
+#include "../Level.hpp"
+#include "Tower.hpp"
+#include "TowerView.hpp"
+
+TowerView::TowerView(
+	const EntityRegistry<Tower> & towers, Handle<Tower> tower,
+	const CreepStore & creeps, Game & game)
+	: towers_(towers)
+	, tower_(tower)
+	, position_(towers.find(tower)->getPosition())
+	, lastShotCount_(towers.find(tower)->getShotCount())
+{
+	const auto & typeName = towers.find(tower)->getTypeName();
+
+	if (typeName == "Wall") {
+		displayComponent_ = std::make_unique<TowerSimpleDisplayComponent>(
+			position_, game.getTexture("Wall"));
+		return;
+	}
+
+	displayComponent_ = std::make_unique<TowerTargettingDisplayComponent>(towers, tower, creeps,
+		position_, game.getTexture("Tower"), game.getTexture("TowerHead"));
+	sound_.setBuffer(game.getSound(typeName == "LaserTower" ? "Laser" : "Tower"));
+}
+
+void TowerView::update(const sf::Time & /*dt*/)
+{
+	const auto shotCount = towers_.find(tower_)->getShotCount();
+	if (shotCount != lastShotCount_) {
+		sound_.play();
+		lastShotCount_ = shotCount;
+	}
+}
+
+void TowerView::render(SpriteBatch & batch)
+{
+	displayComponent_->render(batch);
+}
+
+bool TowerView::isHit(sf::Vector2f point) const
+{
+	const sf::FloatRect rect = {
+		position_.x - 0.5f, position_.y - 0.5f,
+		1.f, 1.f
+	};
+	return rect.contains(point);
+}
+
+sfg::Widget::Ptr TowerView::getPanel(std::shared_ptr<LevelInstance> levelInstance)
+{
+	auto label = sfg::Label::Create("Tower #" + std::to_string(tower_.slot));
+
+	auto sellButton = sfg::Button::Create("Sell for " + std::to_string(towers_.find(tower_)->getSellCost()));
+	const auto tower = tower_;
+	sellButton->GetSignal(sfg::Button::OnLeftClick).Connect([tower, levelInstance]() {
+		levelInstance->sellTower(tower);
+	});
+
+	auto layout = sfg::Box::Create(sfg::Box::Orientation::VERTICAL);
+	layout->PackEnd(label, false);
+	layout->PackEnd(sellButton, false);
+	return layout;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#ifndef TDF_TOWER_VIEW_HPP
+#define TDF_TOWER_VIEW_HPP
+
+#include <memory>
+#include <SFML/Graphics.hpp>
+#include <SFML/Audio.hpp>
+
+#include "../EntityRegistry.hpp"
+#include "../Selectable.hpp"
+#include "../Renderable.hpp"
+#include "TowerDisplayComponent.hpp"
+
+class Tower;
+class Game;
+
+//! \brief The visual side of a Tower.
+//! Besides drawing the Tower it plays a sound whenever the Tower shoots.
+class TowerView final : public Selectable, public Renderable
+{
+private:
+	const EntityRegistry<Tower> & towers_;
+	Handle<Tower> tower_;
+	//! Towers do not move, and the position is needed after the Tower is sold.
+	sf::Vector2f position_;
+	std::unique_ptr<TowerDisplayComponent> displayComponent_;
+	sf::Sound sound_;
+	uint32_t lastShotCount_;
+
+public:
+	TowerView(
+		const EntityRegistry<Tower> & towers, Handle<Tower> tower,
+		const CreepStore & creeps, Game & game);
+
+	//! Returns if the Tower was sold.
+	inline bool isExpired() const
+	{
+		return !towers_.contains(tower_);
+	}
+
+	inline sf::Vector2f getPosition() const
+	{
+		return position_;
+	}
+
+	virtual void update(const sf::Time & dt) override;
+	virtual void render(SpriteBatch & batch) override;
+	virtual bool isHit(sf::Vector2f point) const override;
+	virtual sfg::Widget::Ptr getPanel(std::shared_ptr<LevelInstance> levelInstance) override;
+};
+
+#endif // TDF_TOWER_VIEW_HPP
@@ -0,0 +1,66 @@
+#include <algorithm>
+#include "Level.hpp"
+#include "TowerLayout.hpp"
+
+using json = nlohmann::json;
+
+TowerLayout::TowerLayout(const json & data)
+{
+	load(data);
+}
+
+TowerLayout::TowerLayout(std::istream & source)
+{
+	json data;
+	source >> data;
+	load(data);
+}
+
+void TowerLayout::load(const json & data)
+{
+	for (const auto & tower : data["towers"]) {
+		placement_t placement;
+		placement.tick = tower.count("tick") ? (int64_t)tower["tick"] : 0;
+		placement.towerName = tower["type"];
+		placement.position = { tower["at"][0], tower["at"][1] };
+		addPlacement(placement);
+	}
+}
+
+void TowerLayout::addPlacement(const placement_t & placement)
+{
+	// Keep placements sorted by tick, preserving the order within a tick
+	const auto it = std::upper_bound(placements_.begin(), placements_.end(), placement);
+	placements_.insert(it, placement);
+}
+
+void TowerLayout::write(std::ostream & target) const
+{
+	json towers = json::array();
+	for (const auto & placement : placements_) {
+		towers.push_back({
+			{ "type", placement.towerName },
+			{ "at", { placement.position.x, placement.position.y } },
+			{ "tick", placement.tick }
+		});
+	}
+
+	target << json({ { "towers", towers } }).dump(1) << std::endl;
+}
+
+int32_t TowerLayout::apply(LevelInstance & levelInstance, int64_t tick) const
+{
+	placement_t key;
+	key.tick = tick;
+
+	int32_t failed = 0;
+	const auto from = std::lower_bound(placements_.begin(), placements_.end(), key);
+	const auto to = std::upper_bound(from, placements_.end(), key);
+	for (auto it = from; it != to; ++it) {
+		if (!levelInstance.canPlaceTowerHere(it->position)
+			|| !levelInstance.createTowerAt(it->towerName, it->position))
+			++failed;
+	}
+
+	return failed;
+}
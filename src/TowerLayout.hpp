@@ -0,0 +1,63 @@
+#pragma once
+
+#ifndef TDF_TOWER_LAYOUT_HPP
+#define TDF_TOWER_LAYOUT_HPP
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <json.hpp>
+
+#include <SFML/System.hpp>
+
+class LevelInstance;
+
+//! \brief A scripted list of towers to build during a level.
+//! Used to play a level without a player, e.g. in the batch simulator.
+//! The JSON description looks like:
+//! { "towers": [ { "type": "Tower", "at": [ 5, 5 ], "tick": 0 }, ... ] }
+//! where "tick" is optional and defaults to 0.
+class TowerLayout
+{
+public:
+	struct placement_t
+	{
+		int64_t tick;
+		std::string towerName;
+		sf::Vector2i position;
+
+		inline bool operator<(const placement_t & other) const
+		{
+			return tick < other.tick;
+		}
+	};
+
+private:
+	std::vector<placement_t> placements_;
+
+	void load(const nlohmann::json & data);
+
+public:
+	TowerLayout() {}
+	TowerLayout(const nlohmann::json & data);
+	TowerLayout(std::istream & source);
+
+	void addPlacement(const placement_t & placement);
+
+	//! Writes the layout in the JSON form it is read from.
+	void write(std::ostream & target) const;
+
+	const std::vector<placement_t> & getPlacements() const
+	{
+		return placements_;
+	}
+
+	//! \brief Builds towers scheduled for the given tick.
+	//! Returns how many of them could not be built.
+	int32_t apply(LevelInstance & levelInstance, int64_t tick) const;
+};
+
+#endif // TDF_TOWER_LAYOUT_HPP
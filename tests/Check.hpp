@@ -0,0 +1,32 @@
+#pragma once
+
+#ifndef TDF_CHECK_HPP
+#define TDF_CHECK_HPP
+
+#include <iostream>
+
+//! How many checks have failed so far in this test.
+inline int & checkFailures()
+{
+	static int failures = 0;
+	return failures;
+}
+
+//! Reports a failed condition and carries on, so that a test shows all its failures.
+#define TDF_CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+			++checkFailures(); \
+		} \
+	} while (false)
+
+//! Exit code of a test: zero if no check failed.
+inline int checkResult()
+{
+	if (checkFailures())
+		std::cerr << checkFailures() << " checks failed" << std::endl;
+	return checkFailures() ? 1 : 0;
+}
+
+#endif // TDF_CHECK_HPP
@@ -0,0 +1,124 @@
+#include <memory>
+#include <sstream>
+
+#include <SFML/Graphics.hpp>
+
+#include "Check.hpp"
+#include "Constants.hpp"
+#include "Level.hpp"
+#include "LevelBackground.hpp"
+
+// Checks that the floor of a level, however big, is drawn with one draw call
+// per frame, whether the view shows all of it, a part or only the margin.
+
+//! \brief Counts draw calls instead of drawing.
+//! Every draw activates the target first; refusing makes it draw nothing,
+//! so no window or OpenGL context is needed.
+class CountingRenderTarget : public sf::RenderTarget
+{
+private:
+#if SFML_VERSION_MAJOR == 2 && SFML_VERSION_MINOR < 5
+	virtual bool activate(bool active) override
+#else
+	virtual bool setActive(bool active) override
+#endif
+	{
+		if (active)
+			++draws_;
+		return false;
+	}
+
+	unsigned draws_;
+
+public:
+	CountingRenderTarget()
+		: draws_(0)
+	{
+		initialize();
+	}
+
+	virtual sf::Vector2u getSize() const override
+	{
+		return { 800, 600 };
+	}
+
+	//! Returns the number of draw calls since the last call.
+	unsigned takeDraws()
+	{
+		const unsigned draws = draws_;
+		draws_ = 0;
+		return draws;
+	}
+};
+
+static std::shared_ptr<Level> makeLevel(int32_t size)
+{
+	std::ostringstream description;
+	description << "{ \"name\": \"Floor\", \"starting-lives\": 10, \"starting-money\": 1000000,"
+		<< " \"grid-size\": [ " << size << ", " << size << " ], \"goal\": [ 0, 0 ],"
+		<< " \"waves\": [ { \"start-time\": 1.0, \"creeps\": ["
+		<< " { \"type\": \"GenericCreep\", \"hp\": 40, \"bounty\": 10,"
+		<< " \"spawn-at\": [ " << size - 1 << ", " << size - 1 << " ],"
+		<< " \"spawn-time\": { \"start\": 0.0, \"count\": 10, \"interval\": 0.5 } } ] } ] }";
+
+	std::istringstream source(description.str());
+	return std::make_shared<Level>(source);
+}
+
+//! Draws a frame of the background seen through the area, and returns the draw calls made.
+static unsigned renderFrame(LevelBackground & background, CountingRenderTarget & target, const sf::FloatRect & area)
+{
+	target.setView(sf::View(area));
+	background.render(target, area);
+	return target.takeDraws();
+}
+
+int main()
+{
+	const sf::Time dt = sf::seconds(Constants::SECONDS_PER_FRAME);
+
+	for (int32_t size : { 2, 25, 300 }) {
+		auto levelInstance = std::make_shared<LevelInstance>(makeLevel(size), 0);
+		levelInstance->resume();
+		LevelBackground background(*levelInstance, nullptr);
+		CountingRenderTarget target;
+
+		const float margin = (float)LevelBackground::MARGIN;
+		const float whole = size + 2.f * margin;
+		const sf::FloatRect everything(-margin - 1.f, -margin - 1.f, whole + 2.f, whole + 2.f);
+		const sf::FloatRect corner(-2.f, -2.f, 8.f, 6.f);
+		const sf::FloatRect marginOnly(-margin, -margin, margin - 2.f, margin - 2.f);
+
+		TDF_CHECK(renderFrame(background, target, everything) == 1);
+		TDF_CHECK(background.getVisibleTileCount() == background.getTileCount());
+		TDF_CHECK(renderFrame(background, target, corner) == 1);
+		TDF_CHECK(background.getVisibleTileCount() < background.getTileCount());
+		TDF_CHECK(renderFrame(background, target, marginOnly) == 1);
+
+		// Frames keep one draw call while Creeps walk and Towers change the tints
+		const sf::Vector2i wall = { size / 2, 0 };
+		TDF_CHECK(levelInstance->canPlaceTowerHere(wall) && levelInstance->createTowerAt("Wall", wall));
+		for (int frame = 0; frame < 120; ++frame) {
+			levelInstance->update(dt);
+			TDF_CHECK(renderFrame(background, target, frame % 2 ? everything : corner) == 1);
+		}
+
+		// Tiles are tinted again only in frames after a Creep changed fields
+		int32_t retinted = 0, unchanged = 0;
+		renderFrame(background, target, everything);
+		for (int frame = 0; frame < 240; ++frame) {
+			const uint64_t version = levelInstance->getTowerPlacementVersion();
+			levelInstance->update(dt);
+			renderFrame(background, target, everything);
+			if (levelInstance->getTowerPlacementVersion() == version) {
+				TDF_CHECK(background.getTintedTileCount() == 0);
+				++unchanged;
+			}
+			else
+				retinted += background.getTintedTileCount() > 0;
+		}
+		TDF_CHECK(unchanged > retinted);
+	}
+
+	return checkResult();
+}
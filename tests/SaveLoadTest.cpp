@@ -0,0 +1,108 @@
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "BinaryStream.hpp"
+#include "Check.hpp"
+#include "Constants.hpp"
+#include "Level.hpp"
+
+// Plays a level with a save and a load in the middle, and checks that it
+// ends exactly like the same game played without stopping.
+
+static const uint64_t SEED = 7;
+static const uint64_t TICKS = 3000;
+
+static std::shared_ptr<Level> makeLevel()
+{
+	std::istringstream source(
+		"{ \"name\": \"Round trip\", \"starting-lives\": 20, \"starting-money\": 400,"
+		" \"grid-size\": [ 16, 16 ], \"goal\": [ 8, 8 ],"
+		" \"waves\": [ { \"start-time\": 1.0, \"creeps\": ["
+		" { \"type\": \"GenericCreep\", \"hp\": 60, \"bounty\": 5, \"spawn-at\": [ 0, 0 ],"
+		" \"spawn-time\": { \"start\": 0.0, \"count\": 20, \"interval\": 1.0 } },"
+		" { \"type\": \"GenericCreep\", \"hp\": 60, \"bounty\": 5, \"spawn-at\": [ 15, 15 ],"
+		" \"spawn-time\": { \"start\": 0.5, \"count\": 20, \"interval\": 1.0 } } ] } ] }");
+	return std::make_shared<Level>(source);
+}
+
+static std::string save(const LevelInstance & levelInstance)
+{
+	BinaryWriter writer;
+	levelInstance.save(writer);
+	return writer.takeBuffer();
+}
+
+//! Plays from the current tick up to the given one, building towers on the way.
+static void play(LevelInstance & levelInstance, uint64_t until)
+{
+	const sf::Time dt = sf::seconds(Constants::SECONDS_PER_FRAME);
+	while (levelInstance.getTick() < until) {
+		if (levelInstance.getTick() == 0) {
+			levelInstance.createTowerAt("Tower", { 4, 4 });
+			levelInstance.createTowerAt("LaserTower", { 11, 11 });
+		}
+		if (levelInstance.getTick() == 900)
+			levelInstance.createTowerAt("LongRangeTower", { 6, 9 });
+		levelInstance.update(dt);
+	}
+}
+
+int main()
+{
+	auto level = makeLevel();
+
+	auto straight = std::make_shared<LevelInstance>(level, SEED);
+	straight->resume();
+	play(*straight, TICKS);
+	const std::string expected = save(*straight);
+
+	// Stop at several moments, including ones with Bullets in flight
+	std::string snapshot;
+	for (uint64_t stop : { 1, 450, 1000, 1777 }) {
+		auto before = std::make_shared<LevelInstance>(level, SEED);
+		before->resume();
+		play(*before, stop);
+		snapshot = save(*before);
+
+		auto after = std::make_shared<LevelInstance>(level, SEED + 1);
+		BinaryReader reader(snapshot);
+		after->load(reader);
+		TDF_CHECK(reader.atEnd());
+		TDF_CHECK(save(*after) == snapshot);
+
+		play(*after, TICKS);
+		TDF_CHECK(after->getLives() == straight->getLives());
+		TDF_CHECK(after->getMoney() == straight->getMoney());
+		TDF_CHECK(after->getCreeps().size() == straight->getCreeps().size());
+		TDF_CHECK(save(*after) == expected);
+	}
+
+	// Cut off snapshots are refused, not half loaded
+	auto truncated = std::make_shared<LevelInstance>(level, SEED + 1);
+	truncated->resume();
+	play(*truncated, 600);
+	const std::string untouched = save(*truncated);
+	for (size_t size = 0; size < snapshot.size(); ++size) {
+		bool threw = false;
+		try {
+			BinaryReader reader(snapshot.data(), size);
+			truncated->load(reader);
+		}
+		catch (std::runtime_error &) {
+			threw = true;
+		}
+		TDF_CHECK(threw);
+		TDF_CHECK(save(*truncated) == untouched);
+	}
+
+	// The level still plays on from where it was
+	auto unstopped = std::make_shared<LevelInstance>(level, SEED + 1);
+	unstopped->resume();
+	play(*unstopped, 1200);
+	play(*truncated, 1200);
+	TDF_CHECK(save(*truncated) == save(*unstopped));
+
+	return checkResult();
+}
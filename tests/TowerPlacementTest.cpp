@@ -0,0 +1,139 @@
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "Check.hpp"
+#include "Level.hpp"
+
+// Checks the placement oracle on a 2048x2048 level against a brute force
+// search. On an open grid the dfs of the oracle snakes through almost every
+// cell, millions deep, which a recursive dfs would not survive.
+
+static const int32_t SIZE = 2048;
+
+static const sf::Vector2i GOAL = { SIZE / 2, SIZE / 2 };
+static const sf::Vector2i POCKET_SPAWN = { SIZE - 8, SIZE - 8 };
+static const sf::Vector2i CORNER_SPAWN = { 0, SIZE - 1 };
+
+static std::shared_ptr<Level> makeLevel()
+{
+	std::ostringstream description;
+	description << "{ \"name\": \"Big level\", \"starting-lives\": 10, \"starting-money\": 1000000,"
+		<< " \"grid-size\": [ " << SIZE << ", " << SIZE << " ],"
+		<< " \"goal\": [ " << GOAL.x << ", " << GOAL.y << " ],"
+		<< " \"waves\": [ { \"start-time\": 3.0, \"creeps\": ["
+		<< " { \"type\": \"GenericCreep\", \"hp\": 40, \"bounty\": 10,"
+		<< " \"spawn-at\": [ " << POCKET_SPAWN.x << ", " << POCKET_SPAWN.y << " ], \"spawn-time\": 0.0 },"
+		<< " { \"type\": \"GenericCreep\", \"hp\": 40, \"bounty\": 10,"
+		<< " \"spawn-at\": [ " << CORNER_SPAWN.x << ", " << CORNER_SPAWN.y << " ], \"spawn-time\": 0.0 }"
+		<< " ] } ] }";
+
+	std::istringstream source(description.str());
+	return std::make_shared<Level>(source);
+}
+
+//! Cells with a Tower on them.
+static std::vector<uint8_t> findBlocked(const LevelInstance & levelInstance)
+{
+	std::vector<uint8_t> blocked(SIZE * SIZE, 0);
+	for (int32_t y = 0; y < SIZE; ++y) {
+		for (int32_t x = 0; x < SIZE; ++x)
+			blocked[y * SIZE + x] = levelInstance.hasTowerAt(x, y);
+	}
+	return blocked;
+}
+
+//! Tells if a Tower at the cell would leave every spawn point reachable from the goal.
+static bool bruteForce(const std::vector<uint8_t> & blocked, sf::Vector2i at)
+{
+	if (at == GOAL || at == POCKET_SPAWN || at == CORNER_SPAWN || blocked[at.y * SIZE + at.x])
+		return false;
+
+	std::vector<uint8_t> reached(blocked);
+	reached[at.y * SIZE + at.x] = 1;
+	std::vector<int32_t> queue;
+	queue.reserve(SIZE * SIZE);
+	queue.push_back(GOAL.y * SIZE + GOAL.x);
+	reached[queue.front()] = 1;
+	for (size_t i = 0; i < queue.size(); ++i) {
+		const int32_t current = queue[i];
+		auto visit = [&](int32_t next) {
+			if (!reached[next]) {
+				reached[next] = 1;
+				queue.push_back(next);
+			}
+		};
+		if (current / SIZE < SIZE - 1)
+			visit(current + SIZE);
+		if (current / SIZE > 0)
+			visit(current - SIZE);
+		if (current % SIZE < SIZE - 1)
+			visit(current + 1);
+		if (current % SIZE > 0)
+			visit(current - 1);
+	}
+
+	// Cells blocked from the start count as reached too, but spawn points never are
+	return reached[POCKET_SPAWN.y * SIZE + POCKET_SPAWN.x]
+		&& reached[CORNER_SPAWN.y * SIZE + CORNER_SPAWN.x];
+}
+
+int main()
+{
+	auto level = makeLevel();
+	auto levelInstance = std::make_shared<LevelInstance>(level, 0);
+
+	// Walls around the pocket spawn, which leave it a door and a corridor:
+	// .#.#.
+	// .#.#.
+	// ##.##
+	// #...#
+	// #.S.#
+	// #...#
+	// #####
+	const sf::Vector2i walls[] = {
+		{ -2, -2 }, { -1, -2 }, { 1, -2 }, { 2, -2 },
+		{ -2, -1 }, { 2, -1 }, { -2, 0 }, { 2, 0 }, { -2, 1 }, { 2, 1 },
+		{ -2, 2 }, { -1, 2 }, { 0, 2 }, { 1, 2 }, { 2, 2 },
+		{ -1, -3 }, { 1, -3 }, { -1, -4 }, { 1, -4 }
+	};
+	for (const auto & wall : walls)
+		TDF_CHECK(levelInstance->createTowerAt("Wall", POCKET_SPAWN + wall));
+
+	std::vector<sf::Vector2i> queries;
+	for (int32_t y = -6; y <= 4; ++y) {
+		for (int32_t x = -4; x <= 4; ++x)
+			queries.push_back(POCKET_SPAWN + sf::Vector2i(x, y));
+	}
+	queries.push_back(GOAL);
+	queries.push_back(GOAL + sf::Vector2i(1, 0));
+	queries.push_back(CORNER_SPAWN);
+	queries.push_back(CORNER_SPAWN + sf::Vector2i(1, 0));
+	queries.push_back({ 0, 0 });
+	queries.push_back({ SIZE - 1, SIZE - 1 });
+	queries.push_back({ SIZE / 3, SIZE / 5 });
+
+	size_t allowed = 0;
+	auto blocked = findBlocked(*levelInstance);
+	for (const auto & at : queries) {
+		const bool expected = bruteForce(blocked, at);
+		TDF_CHECK(levelInstance->canPlaceTowerHere(at) == expected);
+		allowed += expected;
+	}
+
+	// The door, the corridor and the cell between them and the spawn are cut points
+	TDF_CHECK(!levelInstance->canPlaceTowerHere(POCKET_SPAWN + sf::Vector2i(0, -2)));
+	TDF_CHECK(!levelInstance->canPlaceTowerHere(POCKET_SPAWN + sf::Vector2i(0, -4)));
+	TDF_CHECK(!levelInstance->canPlaceTowerHere(POCKET_SPAWN + sf::Vector2i(0, -1)));
+	TDF_CHECK(allowed > 0 && allowed < queries.size());
+
+	// Opening a second door makes the corridor free to block
+	levelInstance->sellTower(levelInstance->getTowerAt(POCKET_SPAWN + sf::Vector2i(2, 0)));
+	blocked = findBlocked(*levelInstance);
+	for (const auto & at : queries)
+		TDF_CHECK(levelInstance->canPlaceTowerHere(at) == bruteForce(blocked, at));
+	TDF_CHECK(levelInstance->canPlaceTowerHere(POCKET_SPAWN + sf::Vector2i(0, -4)));
+
+	return checkResult();
+}